@@ -5,6 +5,19 @@
 
 #include <iostream>
 #include <coroutine>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+// Expected amount of values the Generator will yield. Use co_await CoroSizeHint{ Amount } inside the Generator
+// function, before the first co_yield, so the values can be collected without reallocations.
+struct CoroSizeHint
+{
+    std::size_t Size;
+};
 
 // Definition of the coroutine Generator which can store a value of a generic type
 template<typename T>
@@ -22,11 +35,15 @@ struct CoroGenerator
     // Definition of the Generator Promise
     struct CoroPromise
     {
-        // Stored value of a generic type
-        T Value;
+        // Pointer to the lastly yielded value. The value itself lives inside the coroutine frame,
+        // so it is never copied and T doesn't have to be default constructible.
+        const T* Value = nullptr;
+
+        // Expected amount of values, given by CoroSizeHint. 0 if it's not known.
+        std::size_t SizeHint = 0;
 
         // Called in order to construct the Generator
-        CoroGenerator get_return_object() { return { CoroGenerator(CoroHandle::from_promise(*this)) }; }
+        CoroGenerator get_return_object() { return CoroGenerator(CoroHandle::from_promise(*this)); }
         
         // Suspend the Generator at the beginning
         std::suspend_always initial_suspend() noexcept { return {}; }
@@ -40,37 +57,156 @@ struct CoroGenerator
         // Called when exception occurs
         void unhandled_exception() {}
 
-        // Called when co_yield is used. Stores the value which comes with this yield
+        // Called when co_yield is used with a variable. Stores the address of the yielded variable,
+        // which stays valid until the Generator is resumed.
+        std::suspend_always yield_value(const T& from)
+        {
+            Value = std::addressof(from);
+            return {};
+        }
+
+        // Called when co_yield is used with a temporary value. The temporary lives until the end of
+        // the co_yield expression, which ends after the Generator is resumed, so it's address can be stored as well.
+        std::suspend_always yield_value(T&& from)
+        {
+            Value = std::addressof(from);
+            return {};
+        }
+
+        // Called when co_yield is used with a value of a different type. The converted value is stored
+        // inside the returned awaiter, which lives in the coroutine frame until the Generator is resumed.
         template<std::convertible_to<T> From>
-        std::suspend_always yield_value(From&& from)
+            requires (!std::same_as<std::remove_cvref_t<From>, T>)
+        auto yield_value(From&& from)
         {
-            Value = std::forward<From>(from);
+            struct ConvertedAwaiter : std::suspend_always
+            {
+                T Converted;
+
+                void await_suspend(CoroHandle Handle) noexcept
+                {
+                    Handle.promise().Value = std::addressof(Converted);
+                }
+            };
+            return ConvertedAwaiter{ {}, T(std::forward<From>(from)) };
+        }
+
+        // Called when co_await is used with the size hint. The hint is only remembered, the Generator is not suspended.
+        // Generators shouldn't wait for anything else, so co_await with any other type won't compile.
+        std::suspend_never await_transform(CoroSizeHint Hint) noexcept
+        {
+            SizeHint = Hint.Size;
             return {};
         }
     };
 
-    // Stores the coroutine Handle used within this Generator
-    CoroHandle Handle;
+    // Iterator which resumes the Generator when incremented and gives access to the lastly yielded value
+    class Iterator
+    {
+    public:
+
+        // Types required by the std::input_iterator concept
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        // Iterators must be default constructible in order to be used with std::ranges
+        Iterator() = default;
+
+        // Constructor - remember the Handle of the iterated Generator
+        explicit Iterator(CoroHandle InHandle) : Handle(InHandle) {}
+
+        // Get the lastly yielded value by reference, directly from the coroutine frame
+        const T& operator*() const { return *Handle.promise().Value; }
+
+        // Resume the Generator, so it yields the next value
+        Iterator& operator++()
+        {
+            Handle.resume();
+            return *this;
+        }
+
+        // Post increment doesn't have to return anything for input iterators
+        void operator++(int) { ++*this; }
 
-    // Try to resume the Generator and check if it's execution is done
-    explicit operator bool()
+        // Iterator reached the end when the Generator has finished
+        bool operator==(std::default_sentinel_t) const { return Handle.done(); }
+
+    private:
+
+        // Handle of the iterated Generator
+        CoroHandle Handle;
+    };
+
+    // Start the Generator and get the Iterator to the first yielded value
+    Iterator begin()
     {
         Handle.resume();
-        return !Handle.done();
+        return Iterator(Handle);
     }
 
-    // Get the lastly stored by co_yield value
-    T operator()()
+    // The end of the Generator is represented by the default sentinel, because it is not known until the Generator finishes
+    std::default_sentinel_t end() { return {}; }
+
+    // Append all values to the given container. The Generator is started first, so it can give the size hint,
+    // and the container reserves the memory once, before any value is added.
+    template<typename Container>
+    void CollectInto(Container& Out)
     {
-        return std::move(Handle.promise().Value);
+        Iterator It = begin();
+        if constexpr (requires { Out.reserve(Out.size()); })
+        {
+            Out.reserve(Out.size() + Handle.promise().SizeHint);
+        }
+        for (; It != end(); ++It)
+        {
+            Out.push_back(*It);
+        }
+    }
+
+    // Collect all values into a new vector
+    std::vector<T> ToVector()
+    {
+        std::vector<T> Result;
+        CollectInto(Result);
+        return Result;
     }
 
     // Constructor - save the coroutine Handle given during the get_return_object call in the Promise
-    CoroGenerator(CoroHandle InHandle) : Handle(InHandle) {}
+    explicit CoroGenerator(CoroHandle InHandle) : Handle(InHandle) {}
+
+    // Generator owns the coroutine Handle, so copying it would destroy the same coroutine twice
+    CoroGenerator(const CoroGenerator&) = delete;
+    CoroGenerator& operator=(const CoroGenerator&) = delete;
+
+    // Moving the Generator passes the ownership of the coroutine Handle
+    CoroGenerator(CoroGenerator&& Other) noexcept : Handle(std::exchange(Other.Handle, {})) {}
+    CoroGenerator& operator=(CoroGenerator&& Other) noexcept
+    {
+        if (this != &Other)
+        {
+            if (Handle)
+            {
+                Handle.destroy();
+            }
+            Handle = std::exchange(Other.Handle, {});
+        }
+        return *this;
+    }
 
     // Destructor - explicitly destroy the coroutine Handle, because it is not destroyed automatically, because
     // of the final_suspend set to suspend_always
-    ~CoroGenerator() { Handle.destroy(); }
+    ~CoroGenerator()
+    {
+        if (Handle)
+        {
+            Handle.destroy();
+        }
+    }
+
+private:
+
+    // Stores the coroutine Handle used within this Generator
+    CoroHandle Handle;
 };
 
 // Fibonacci Sequence Generator. Yields every next value of the sequence and suspends it's execution.
@@ -81,6 +217,9 @@ CoroGenerator<int> FibonacciGenerator(const int Amount)
         co_return;
     }
 
+    // Tell how many values will be yielded
+    co_await CoroSizeHint{ static_cast<std::size_t>(Amount) };
+
     int n1 = 1;
     int n2 = 1;
     for (int i = 1; i <= Amount; i++)
@@ -99,6 +238,31 @@ CoroGenerator<int> FibonacciGenerator(const int Amount)
     }
 }
 
+// Big chunk of data which can't be copied and doesn't have a default constructor
+struct DataChunk
+{
+    explicit DataChunk(int InIndex) : Index(InIndex) {}
+    DataChunk(const DataChunk&) = delete;
+    DataChunk& operator=(const DataChunk&) = delete;
+
+    int Index;
+    int Data[1024] = {};
+};
+
+// Generator of data chunks. The chunk is yielded by reference, the consumer reads it directly from this coroutine frame.
+CoroGenerator<DataChunk> ChunkGenerator(const int Amount)
+{
+    for (int i = 0; i < Amount; i++)
+    {
+        DataChunk Chunk(i);
+        Chunk.Data[0] = i * 10;
+        co_yield Chunk;
+    }
+}
+
+// The Generator can be used with every range algorithm and view
+static_assert(std::ranges::input_range<CoroGenerator<int>>);
+
 // Main program
 int main()
 {
@@ -106,13 +270,32 @@ int main()
     // will not start immediately.
     auto generator = FibonacciGenerator(10);
 
-    // Every time a bool() operator is called the Generator resumes it's execution and checks if the coroutine has finished.
-    // When the coroutine has finished the wile loop will finish.
-    while (generator)
+    // The range-based for loop calls begin(), which starts the Generator, and then it increments the Iterator,
+    // which resumes the Generator, until the Iterator is equal to end(), which means the coroutine has finished.
+    for (const int Value : generator)
+    {
+        // Print every value yielded by the Generator.
+        std::cout << Value << " ";
+    }
+    std::cout << "\n";
+
+    // Because the Generator is a range it can be combined with views. Only the even values are printed here.
+    for (const int Value : FibonacciGenerator(10) | std::views::filter([](int Value) { return Value % 2 == 0; }))
     {
-        // Get and print every value yielded by  the Generator.
-        std::cout << generator() << " ";
+        std::cout << Value << " ";
     }
+    std::cout << "\n";
+
+    // Chunks are not copied when yielded, they are accessed in place.
+    for (const DataChunk& Chunk : ChunkGenerator(3))
+    {
+        std::cout << Chunk.Index << ":" << Chunk.Data[0] << " ";
+    }
+    std::cout << "\n";
+
+    // Collecting values reserves the memory for all of them at once, thanks to the size hint
+    const std::vector<int> Values = FibonacciGenerator(40).ToVector();
+    std::cout << "Collected " << Values.size() << " values, capacity " << Values.capacity() << "\n";
 
     // To check if the coroutine has finished the final_suspend was set to suspend_always. Thanks to that
     // the coroutine will not be destroyed automatically when it finishes. This will allow us to check the Handle
@@ -125,4 +308,7 @@ int main()
  The program should output:
 
  1 1 2 3 5 8 13 21 34 55
+ 2 8 34
+ 0:0 1:10 2:20
+ Collected 40 values, capacity 40
 */
\ No newline at end of file
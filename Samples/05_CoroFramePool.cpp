@@ -0,0 +1,357 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutines which allocate their frames from a pool instead of the global heap.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Set to 0 to use one global, mutex guarded pool instead of a separate pool for every thread.
+#ifndef CORO_POOL_THREAD_LOCAL
+#define CORO_POOL_THREAD_LOCAL 1
+#endif
+
+// Owns the memory of every pool chunk. Chunks are never given back to the heap before the program ends,
+// so a frame allocated on one thread can be safely returned to the free list of another thread.
+class CoroChunkStorage
+{
+public:
+
+    // Get the one and only chunk storage
+    static CoroChunkStorage& Get()
+    {
+        static CoroChunkStorage Storage;
+        return Storage;
+    }
+
+    // Allocate a new chunk from the global heap
+    std::byte* AllocateChunk(std::size_t Size)
+    {
+        std::byte* Chunk = static_cast<std::byte*>(::operator new(Size));
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Chunks.push_back(Chunk);
+        return Chunk;
+    }
+
+    // Number of chunks taken from the global heap so far
+    std::size_t GetNumChunks()
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        return Chunks.size();
+    }
+
+    // Release all chunks when the program ends
+    ~CoroChunkStorage()
+    {
+        for (std::byte* Chunk : Chunks)
+        {
+            ::operator delete(Chunk);
+        }
+    }
+
+private:
+
+    std::mutex Mutex;
+    std::vector<std::byte*> Chunks;
+};
+
+// Pool of coroutine frames split into size classes. Every size class has its own free list.
+// Frames bigger than the biggest size class are allocated from the global heap.
+class CoroFramePool
+{
+public:
+
+    // Size of the smallest size class. Every next size class is two times bigger.
+    static constexpr std::size_t MinBlockSize = 64;
+
+    // Amount of size classes: 64, 128, 256, 512 and 1024 bytes
+    static constexpr std::size_t NumSizeClasses = 5;
+
+    // Size of the biggest block which can be served by the pool
+    static constexpr std::size_t MaxBlockSize = MinBlockSize << (NumSizeClasses - 1);
+
+    // Amount of blocks taken from the heap at once when the free list of a size class is empty
+    static constexpr std::size_t BlocksPerChunk = 64;
+
+    // Get the pool which should be used by the calling thread
+    static CoroFramePool& Get()
+    {
+#if CORO_POOL_THREAD_LOCAL
+        thread_local CoroFramePool Pool;
+#else
+        static CoroFramePool Pool;
+#endif
+        return Pool;
+    }
+
+    // Get a memory block which fits the frame of the given size
+    void* Allocate(std::size_t Size)
+    {
+        if (Size > MaxBlockSize)
+        {
+            return ::operator new(Size);
+        }
+
+#if !CORO_POOL_THREAD_LOCAL
+        std::lock_guard<std::mutex> Lock(Mutex);
+#endif
+
+        const std::size_t SizeClass = GetSizeClass(Size);
+        if (FreeLists[SizeClass] == nullptr)
+        {
+            Refill(SizeClass);
+        }
+
+        FreeBlock* Block = FreeLists[SizeClass];
+        FreeLists[SizeClass] = Block->Next;
+        return Block;
+    }
+
+    // Give the memory block back to the free list of it's size class
+    void Deallocate(void* Ptr, std::size_t Size)
+    {
+        if (Size > MaxBlockSize)
+        {
+            ::operator delete(Ptr);
+            return;
+        }
+
+#if !CORO_POOL_THREAD_LOCAL
+        std::lock_guard<std::mutex> Lock(Mutex);
+#endif
+
+        const std::size_t SizeClass = GetSizeClass(Size);
+        FreeBlock* Block = static_cast<FreeBlock*>(Ptr);
+        Block->Next = FreeLists[SizeClass];
+        FreeLists[SizeClass] = Block;
+    }
+
+private:
+
+    // Free block is just a node of the intrusive singly linked list stored inside unused memory
+    struct FreeBlock
+    {
+        FreeBlock* Next;
+    };
+
+    // Find the smallest size class which fits the given size
+    static std::size_t GetSizeClass(std::size_t Size)
+    {
+        std::size_t SizeClass = 0;
+        std::size_t BlockSize = MinBlockSize;
+        while (BlockSize < Size)
+        {
+            BlockSize <<= 1;
+            SizeClass++;
+        }
+        return SizeClass;
+    }
+
+    // Cut a new chunk into blocks of the given size class and put them on it's free list
+    void Refill(std::size_t SizeClass)
+    {
+        const std::size_t BlockSize = MinBlockSize << SizeClass;
+        std::byte* Chunk = CoroChunkStorage::Get().AllocateChunk(BlockSize * BlocksPerChunk);
+        for (std::size_t i = 0; i < BlocksPerChunk; i++)
+        {
+            FreeBlock* Block = reinterpret_cast<FreeBlock*>(Chunk + i * BlockSize);
+            Block->Next = FreeLists[SizeClass];
+            FreeLists[SizeClass] = Block;
+        }
+    }
+
+    FreeBlock* FreeLists[NumSizeClasses] = {};
+
+#if !CORO_POOL_THREAD_LOCAL
+    std::mutex Mutex;
+#endif
+};
+
+// Base for every Promise which should allocate it's coroutine frame from the pool.
+// The compiler looks for operator new and operator delete inside the Promise type first,
+// so inheriting from this struct is enough to redirect the frame allocation.
+struct CoroPooledFrame
+{
+    // Called when the coroutine frame is created
+    static void* operator new(std::size_t Size)
+    {
+        return CoroFramePool::Get().Allocate(Size);
+    }
+
+    // Called when the coroutine frame is destroyed. The size is the same as the one given to operator new.
+    static void operator delete(void* Ptr, std::size_t Size)
+    {
+        CoroFramePool::Get().Deallocate(Ptr, Size);
+    }
+};
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroPromise;
+
+    // Called when the coroutine has been resumed
+    void await_resume() {}
+
+    // Indicated that coroutine can be suspended
+    bool await_ready() { return false; }
+
+    // Called when the coroutine has been suspended
+    void await_suspend(std::coroutine_handle<CoroPromise> Handle) {};
+};
+
+// Definition of the coroutine Promise which frame is allocated from the pool
+struct CoroPromise : CoroPooledFrame
+{
+    // Called in order to construct the coroutine Handle
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+
+    // Do not suspend when the coroutine starts
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    // Do not suspend when the coroutine ends
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs
+    void unhandled_exception() {}
+};
+
+// Definition of the coroutine Generator which frame is allocated from the pool
+template<typename T>
+struct CoroGenerator
+{
+    // Forward declaration of the Promise so it can be used for a Handle definition
+    struct CoroPromise;
+
+    // Tell the Generator to use our Promise
+    using promise_type = CoroPromise;
+
+    // Convinient alias for the coroutine Handle type which uses declared Promise
+    using CoroHandle = std::coroutine_handle<CoroPromise>;
+
+    // Definition of the Generator Promise
+    struct CoroPromise : CoroPooledFrame
+    {
+        // Stored value of a generic type
+        T Value;
+
+        // Called in order to construct the Generator
+        CoroGenerator get_return_object() { return { CoroGenerator(CoroHandle::from_promise(*this)) }; }
+
+        // Suspend the Generator at the beginning
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // Suspend the Generator at the end
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        // Called when co_return is used
+        void return_void() {}
+
+        // Called when exception occurs
+        void unhandled_exception() {}
+
+        // Called when co_yield is used. Stores the value which comes with this yield
+        template<std::convertible_to<T> From>
+        std::suspend_always yield_value(From&& from)
+        {
+            Value = std::forward<From>(from);
+            return {};
+        }
+    };
+
+    // Stores the coroutine Handle used within this Generator
+    CoroHandle Handle;
+
+    // Try to resume the Generator and check if it's execution is done
+    explicit operator bool()
+    {
+        Handle.resume();
+        return !Handle.done();
+    }
+
+    // Get the lastly stored by co_yield value
+    T operator()()
+    {
+        return std::move(Handle.promise().Value);
+    }
+
+    // Constructor - save the coroutine Handle given during the get_return_object call in the Promise
+    CoroGenerator(CoroHandle InHandle) : Handle(InHandle) {}
+
+    // Generator owns the coroutine frame, so it can't be copied
+    CoroGenerator(const CoroGenerator&) = delete;
+    CoroGenerator& operator=(const CoroGenerator&) = delete;
+
+    // Destructor - explicitly destroy the coroutine Handle which gives the frame back to the pool
+    ~CoroGenerator() { Handle.destroy(); }
+};
+
+// Definition of the coroutine function
+CoroHandle CoroTest(int& Counter)
+{
+    // Suspends the function. Returns the handle.
+    co_await CoroHandle();
+
+    Counter++;
+}
+
+// Generator which yields numbers from 0 to Amount - 1
+CoroGenerator<int> CountGenerator(const int Amount)
+{
+    for (int i = 0; i < Amount; i++)
+    {
+        co_yield i;
+    }
+}
+
+// Main program
+int main()
+{
+    constexpr int NumCoroutines = 10000;
+
+    // Spawn and finish a lot of short coroutines. Their frames are taken from the pool and given back to it
+    // when the coroutine ends, so the pool needs only one chunk from the global heap.
+    int Counter = 0;
+    for (int i = 0; i < NumCoroutines; i++)
+    {
+        CoroHandle handle = CoroTest(Counter);
+        handle.resume();
+    }
+    std::cout << "Coroutines finished: " << Counter << "\n";
+
+    // The same goes for Generators. The frame is given back to the pool in the Generator destructor.
+    int Sum = 0;
+    for (int i = 0; i < NumCoroutines; i++)
+    {
+        auto generator = CountGenerator(4);
+        while (generator)
+        {
+            Sum += generator();
+        }
+    }
+    std::cout << "Generators sum: " << Sum << "\n";
+
+    // Every finished frame has been reused by the next coroutine, so the amount of chunks stays small.
+    std::cout << "Chunks taken from the heap: " << CoroChunkStorage::Get().GetNumChunks() << "\n";
+
+    return 0;
+}
+
+/**
+ The program should output (the amount of chunks depends on the compiler, but it doesn't grow with the amount of coroutines):
+
+ Coroutines finished: 10000
+ Generators sum: 60000
+ Chunks taken from the heap: 1
+*/
@@ -0,0 +1,168 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of coroutines in Unreal Engine 5 which share one ticker for all waiting tasks.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <coroutine>
+#include "Containers/Ticker.h"
+#include "Kismet/GameplayStatics.h"
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroPromise;
+};
+
+// Definition of the coroutine Promise
+struct CoroPromise
+{
+    // Called in order to construct the coroutine Handle
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+
+    // Do not suspend when the coroutine starts
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    // Do not suspend when the coroutine ends
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs
+    void unhandled_exception() {}
+};
+
+// Queue of all suspended coroutines waiting for a specific time, sorted by their deadlines (min-heap).
+// It uses only one Unreal ticker, no matter how many coroutines are waiting. Every frame it checks only
+// the earliest deadline, so the cost of the tick depends on the amount of the expired waits, not the waiting ones.
+class CoroTimerQueue
+{
+public:
+
+    // Get the one and only timer queue
+    static CoroTimerQueue& Get()
+    {
+        static CoroTimerQueue Queue;
+        return Queue;
+    }
+
+    // Suspend given coroutine Handle until the given amount of time passes
+    void Add(float Time, std::coroutine_handle<> Handle)
+    {
+        // Start the Unreal ticker with the first waiting coroutine
+        if (TickerHandle.IsValid() == false)
+        {
+            TickerHandle = FTSTicker::GetCoreTicker().AddTicker(TEXT("CoroTimerQueue"), 0.f, [this](float DeltaTime) -> bool
+            {
+                Tick(DeltaTime);
+                return true;
+            });
+        }
+
+        Timers.HeapPush({ CurrentTime + Time, NextSequence++, Handle }, FTimerPredicate());
+    }
+
+    // Amount of coroutines currently waiting in the queue
+    int32 Num() const { return Timers.Num(); }
+
+private:
+
+    // Single suspended coroutine and the time it should be resumed at
+    struct FTimer
+    {
+        double Deadline;
+
+        // Keeps the order of timers with the same deadline, so they are resumed in the order they were added
+        uint64 Sequence;
+
+        std::coroutine_handle<> Handle;
+    };
+
+    // Orders the heap so the earliest deadline is always on top
+    struct FTimerPredicate
+    {
+        bool operator()(const FTimer& A, const FTimer& B) const
+        {
+            return A.Deadline < B.Deadline || (A.Deadline == B.Deadline && A.Sequence < B.Sequence);
+        }
+    };
+
+    // Called once per frame by the Unreal ticker
+    void Tick(float DeltaTime)
+    {
+        CurrentTime += DeltaTime;
+
+        // Resume every coroutine which deadline has passed. Resumed coroutines can add new timers,
+        // but their deadlines will be always in the future, so they won't be resumed in this frame.
+        while (Timers.Num() > 0 && Timers.HeapTop().Deadline <= CurrentTime)
+        {
+            FTimer Timer;
+            Timers.HeapPop(Timer, FTimerPredicate());
+            Timer.Handle.resume();
+        }
+    }
+
+    // Time accumulated from all ticks
+    double CurrentTime = 0.0;
+
+    // Sequence number for the next added timer
+    uint64 NextSequence = 0;
+
+    // All waiting coroutines kept as a min-heap
+    TArray<FTimer> Timers;
+
+    // Unreal ticker handle
+    FTSTicker::FDelegateHandle TickerHandle;
+};
+
+// Definition of the coroutine Task used for suspending a specific amount of time
+class WaitSecondsTask
+{
+private:
+
+    // Time to wait before resume
+    float Time;
+
+public:
+
+    // Task constructor which stores the amount of time to being suspended
+    WaitSecondsTask(float InTime) : Time(InTime) {}
+
+    // Called when the coroutine has been resumed
+    void await_resume() {}
+
+    // Ignore suspension if the given time is invalid
+    bool await_ready() { return Time <= 0.f; }
+
+    // Called when the coroutine has been suspended using this Task. Instead of starting a new ticker
+    // it simply puts the coroutine Handle to the shared timer queue.
+    void await_suspend(std::coroutine_handle<CoroPromise> CoroHandle)
+    {
+        CoroTimerQueue::Get().Add(Time, CoroHandle);
+    };
+};
+
+// Definition of the coroutine function which fades out the camera
+CoroHandle CoroFadeOut()
+{
+    // Warning, there will be velociraptors: World should be obtained by a World Context Object,
+    // but just for the example sake we use nasty GWorld.
+    if (GWorld)
+    {
+        APlayerCameraManager* CameraManager = UGameplayStatics::GetPlayerCameraManager(GWorld, 0);
+        for (int32 Fade = 0; Fade <= 100; Fade += 10)
+        {
+            // Because the WaitSecondsTask can tick between worlds we can't be sure if the Camera Manager
+            // is valid all the time.
+            if (IsValid(CameraManager))
+            {
+                CameraManager->SetManualCameraFade((float)Fade * .01f, FColor::Black, false);
+            }
+            co_await WaitSecondsTask(.1f);
+        }
+    }
+}
@@ -0,0 +1,231 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of lazy c++ coroutine tasks which can await each other using symmetric transfer.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+// Forward declaration of the Task so it can be used inside the Promise
+template<typename T>
+class Task;
+
+// Common part of the Promise of every Task
+struct TaskPromiseBase
+{
+    // Awaiter used when the Task finishes. Instead of returning to the caller of resume() it transfers
+    // the execution directly to the coroutine which awaits this Task.
+    struct FinalAwaiter
+    {
+        // Always suspend, so the awaiting coroutine can read the result before the frame is destroyed
+        bool await_ready() noexcept { return false; }
+
+        // Returning a Handle from await_suspend resumes that Handle without growing the stack
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> Handle) noexcept
+        {
+            return Handle.promise().Continuation;
+        }
+
+        // Never called, because the finished coroutine is never resumed
+        void await_resume() noexcept {}
+    };
+
+    // Coroutine which awaits this Task. If nobody awaits it the noop coroutine simply returns to the caller.
+    std::coroutine_handle<> Continuation = std::noop_coroutine();
+
+    // Exception thrown inside the Task. It will be rethrown in the awaiting coroutine.
+    std::exception_ptr Exception;
+
+    // Suspend the Task at the beginning, so it starts only when awaited
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    // Transfer the execution to the awaiting coroutine at the end
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    // Called when exception occurs. Remember it, so it can be rethrown later.
+    void unhandled_exception() { Exception = std::current_exception(); }
+};
+
+// Definition of the Task Promise which stores the result of a generic type
+template<typename T>
+struct TaskPromise : TaskPromiseBase
+{
+    // Result of the Task set by co_return
+    std::optional<T> Value;
+
+    // Called in order to construct the Task
+    Task<T> get_return_object();
+
+    // Called when co_return is used. Stores the returned value.
+    template<std::convertible_to<T> From>
+    void return_value(From&& from)
+    {
+        Value.emplace(std::forward<From>(from));
+    }
+
+    // Get the result or rethrow the exception thrown inside the Task
+    T GetResult()
+    {
+        if (Exception)
+        {
+            std::rethrow_exception(Exception);
+        }
+        return std::move(*Value);
+    }
+};
+
+// Definition of the Task Promise for Tasks which don't return anything
+template<>
+struct TaskPromise<void> : TaskPromiseBase
+{
+    // Called in order to construct the Task
+    Task<void> get_return_object();
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Rethrow the exception thrown inside the Task
+    void GetResult()
+    {
+        if (Exception)
+        {
+            std::rethrow_exception(Exception);
+        }
+    }
+};
+
+// Definition of the lazy Task. It starts when it is awaited and resumes the awaiting coroutine when it finishes.
+template<typename T = void>
+class Task
+{
+public:
+
+    // Tell the Task to use our Promise
+    using promise_type = TaskPromise<T>;
+
+    // Convinient alias for the coroutine Handle type which uses declared Promise
+    using CoroHandle = std::coroutine_handle<promise_type>;
+
+    // Constructor - save the coroutine Handle given during the get_return_object call in the Promise
+    explicit Task(CoroHandle InHandle) : Handle(InHandle) {}
+
+    // Task owns the coroutine frame, so it can be only moved
+    Task(Task&& Other) noexcept : Handle(std::exchange(Other.Handle, {})) {}
+    Task& operator=(Task&& Other) noexcept
+    {
+        if (this != &Other)
+        {
+            if (Handle)
+            {
+                Handle.destroy();
+            }
+            Handle = std::exchange(Other.Handle, {});
+        }
+        return *this;
+    }
+
+    // Destructor - explicitly destroy the coroutine frame, because the final_suspend always suspends
+    ~Task()
+    {
+        if (Handle)
+        {
+            Handle.destroy();
+        }
+    }
+
+    // Don't suspend if the Task has already finished
+    bool await_ready() const noexcept { return !Handle || Handle.done(); }
+
+    // Remember the awaiting coroutine and start this Task right away, without going through the caller
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> Awaiting) noexcept
+    {
+        Handle.promise().Continuation = Awaiting;
+        return Handle;
+    }
+
+    // Called when the awaiting coroutine is resumed. Returns the result of this Task.
+    T await_resume() { return Handle.promise().GetResult(); }
+
+    // Start the Task manually. Used for the top level Task which is not awaited by any other coroutine.
+    void Start() { Handle.resume(); }
+
+    // Check if the Task has finished
+    bool IsDone() const { return Handle.done(); }
+
+    // Get the result of the finished top level Task
+    T GetResult() { return Handle.promise().GetResult(); }
+
+private:
+
+    // Stores the coroutine Handle used within this Task
+    CoroHandle Handle;
+};
+
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object() { return Task<T>(Task<T>::CoroHandle::from_promise(*this)); }
+
+inline Task<void> TaskPromise<void>::get_return_object() { return Task<void>(Task<void>::CoroHandle::from_promise(*this)); }
+
+// Task which returns a single value
+Task<int> GetValue(int Value)
+{
+    co_return Value;
+}
+
+// Task which awaits other Tasks and returns the sum of their results
+Task<int> SumTask(int A, int B)
+{
+    const int ResultA = co_await GetValue(A);
+    const int ResultB = co_await GetValue(B);
+    co_return ResultA + ResultB;
+}
+
+// Task which awaits itself recursively. Every level of recursion is a separate coroutine frame,
+// but thanks to the symmetric transfer the stack doesn't grow with the depth of the chain.
+// Warning: Clang and MSVC always perform the symmetric transfer as a tail call, but GCC does it only
+// with optimizations enabled (-O2). The chain in this sample is short enough to survive GCC debug builds,
+// but a chain of millions of Tasks would overflow the stack there.
+Task<int> DeepChain(int Depth)
+{
+    if (Depth == 0)
+    {
+        co_return 0;
+    }
+    co_return 1 + co_await DeepChain(Depth - 1);
+}
+
+// Task which doesn't return anything
+Task<> PrintTask()
+{
+    std::cout << "Sum: " << co_await SumTask(2, 3) << "\n";
+    std::cout << "Chain depth: " << co_await DeepChain(10000) << "\n";
+}
+
+// Main program
+int main()
+{
+    // Calls the coroutine function. Because the Task is lazy it is not started yet.
+    Task<> task = PrintTask();
+    std::cout << "Task Created\n";
+
+    // Starts the top level Task. Every nested Task is resumed by the awaiting coroutine and it resumes
+    // the awaiting coroutine back when it finishes.
+    task.Start();
+
+    std::cout << "Task Done: " << task.IsDone() << "\n";
+
+    return 0;
+}
+
+/**
+ The program should output:
+
+ Task Created
+ Sum: 5
+ Chain depth: 10000
+ Task Done: 1
+*/
@@ -0,0 +1,225 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutine generator which yields values in batches.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <utility>
+
+// Definition of the coroutine Generator which collects yielded values inside a fixed size buffer
+// and suspends only when the buffer is full. Thanks to that one resume produces up to N values.
+template<typename T, std::size_t N = 64>
+struct CoroBatchGenerator
+{
+    // Forward declaration of the Promise so it can be used for a Handle definition
+    struct CoroPromise;
+
+    // Tell the Generator to use our Promise
+    using promise_type = CoroPromise;
+
+    // Convinient alias for the coroutine Handle type which uses declared Promise
+    using CoroHandle = std::coroutine_handle<CoroPromise>;
+
+    // Definition of the Generator Promise
+    struct CoroPromise
+    {
+        // Buffer for the yielded values. It is stored inline, inside the coroutine frame.
+        std::array<T, N> Buffer;
+
+        // Amount of values stored in the buffer
+        std::size_t Count = 0;
+
+        // Awaiter which suspends the Generator only when the buffer is full
+        struct YieldAwaiter
+        {
+            bool bFull;
+
+            bool await_ready() noexcept { return !bFull; }
+            void await_suspend(CoroHandle) noexcept {}
+            void await_resume() noexcept {}
+        };
+
+        // Called in order to construct the Generator
+        CoroBatchGenerator get_return_object() { return CoroBatchGenerator(CoroHandle::from_promise(*this)); }
+
+        // Suspend the Generator at the beginning
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // Suspend the Generator at the end. Values left in the buffer form the last batch.
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        // Called when co_return is used
+        void return_void() {}
+
+        // Called when exception occurs
+        void unhandled_exception() {}
+
+        // Called when co_yield is used. Stores the value in the buffer, without suspending the Generator until it is full.
+        template<std::convertible_to<T> From>
+        YieldAwaiter yield_value(From&& from)
+        {
+            Buffer[Count++] = std::forward<From>(from);
+            return { Count == N };
+        }
+    };
+
+    // Iterator which goes through every value of every batch, so the Generator can be used element by element
+    class Iterator
+    {
+    public:
+
+        // Types required by the std::input_iterator concept
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        // Iterators must be default constructible in order to be used with std::ranges
+        Iterator() = default;
+
+        // Constructor - remember the Handle of the Generator, so the Iterator stays valid when the Generator is moved
+        explicit Iterator(CoroHandle InHandle) : Handle(InHandle) {}
+
+        // Get the current value directly from the buffer
+        const T& operator*() const { return GetBatchOf(Handle)[Index]; }
+
+        // Go to the next value in the buffer. Resume the Generator only when the whole batch has been consumed.
+        Iterator& operator++()
+        {
+            if (++Index == GetBatchOf(Handle).size())
+            {
+                Index = 0;
+                NextBatchOf(Handle);
+            }
+            return *this;
+        }
+
+        // Post increment doesn't have to return anything for input iterators
+        void operator++(int) { ++*this; }
+
+        // Iterator reached the end when there are no more values in the buffer
+        bool operator==(std::default_sentinel_t) const { return GetBatchOf(Handle).empty(); }
+
+    private:
+
+        // Handle of the iterated Generator
+        CoroHandle Handle;
+
+        // Index of the current value in the current batch
+        std::size_t Index = 0;
+    };
+
+    // Resume the Generator until it fills the next batch or finishes. Returns false if there are no more values.
+    bool NextBatch() { return NextBatchOf(Handle); }
+
+    // Get the lastly filled batch
+    std::span<const T> GetBatch() const { return GetBatchOf(Handle); }
+
+    // Start the Generator and get the Iterator to the first value
+    Iterator begin()
+    {
+        NextBatch();
+        return Iterator(Handle);
+    }
+
+    // The end of the Generator is represented by the default sentinel
+    std::default_sentinel_t end() { return {}; }
+
+    // Constructor - save the coroutine Handle given during the get_return_object call in the Promise
+    explicit CoroBatchGenerator(CoroHandle InHandle) : Handle(InHandle) {}
+
+    // Generator owns the coroutine Handle, so it can be only moved
+    CoroBatchGenerator(const CoroBatchGenerator&) = delete;
+    CoroBatchGenerator& operator=(const CoroBatchGenerator&) = delete;
+    CoroBatchGenerator(CoroBatchGenerator&& Other) noexcept : Handle(std::exchange(Other.Handle, {})) {}
+    CoroBatchGenerator& operator=(CoroBatchGenerator&& Other) noexcept
+    {
+        if (this != &Other)
+        {
+            if (Handle)
+            {
+                Handle.destroy();
+            }
+            Handle = std::exchange(Other.Handle, {});
+        }
+        return *this;
+    }
+
+    // Destructor - explicitly destroy the coroutine Handle, because of the final_suspend set to suspend_always
+    ~CoroBatchGenerator()
+    {
+        if (Handle)
+        {
+            Handle.destroy();
+        }
+    }
+
+private:
+
+    // Batches are taken from the Handle, so both the Generator and it's Iterator can use them
+    static bool NextBatchOf(CoroHandle Handle)
+    {
+        CoroPromise& Promise = Handle.promise();
+        Promise.Count = 0;
+        if (Handle.done() == false)
+        {
+            Handle.resume();
+        }
+        return Promise.Count > 0;
+    }
+
+    static std::span<const T> GetBatchOf(CoroHandle Handle)
+    {
+        const CoroPromise& Promise = Handle.promise();
+        return std::span<const T>(Promise.Buffer.data(), Promise.Count);
+    }
+
+    // Stores the coroutine Handle used within this Generator
+    CoroHandle Handle;
+};
+
+// Generator which yields numbers from 0 to Amount - 1. It looks exactly like a regular Generator,
+// but it is suspended only once per every 4 yielded values.
+CoroBatchGenerator<int, 4> CountGenerator(const int Amount)
+{
+    for (int i = 0; i < Amount; i++)
+    {
+        co_yield i;
+    }
+}
+
+// Main program
+int main()
+{
+    // Consume the Generator batch by batch
+    auto generator = CountGenerator(10);
+    while (generator.NextBatch())
+    {
+        std::cout << "Batch:";
+        for (const int Value : generator.GetBatch())
+        {
+            std::cout << " " << Value;
+        }
+        std::cout << "\n";
+    }
+
+    // Consume the Generator value by value. It is still resumed only once per batch.
+    for (const int Value : CountGenerator(10))
+    {
+        std::cout << Value << " ";
+    }
+
+    return 0;
+}
+
+/**
+ The program should output:
+
+ Batch: 0 1 2 3
+ Batch: 4 5 6 7
+ Batch: 8 9
+ 0 1 2 3 4 5 6 7 8 9
+*/
@@ -0,0 +1,549 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutines resumed on a work-stealing thread pool.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Chase-Lev work-stealing deque of coroutine Handles. Only the owning worker can push and pop
+// from the bottom, every other worker can steal from the top. The buffer grows when it's full.
+class WorkStealingDeque
+{
+public:
+
+    // Constructor - allocate the initial buffer
+    explicit WorkStealingDeque(int64_t InitialCapacity = 256)
+    {
+        Rings.push_back(std::make_unique<Ring>(InitialCapacity));
+        Array.store(Rings.back().get(), std::memory_order_relaxed);
+    }
+
+    // Push the Handle to the bottom of the deque. Can be called only by the owning worker.
+    void Push(std::coroutine_handle<> Handle)
+    {
+        const int64_t B = Bottom.load(std::memory_order_relaxed);
+        const int64_t T = Top.load(std::memory_order_acquire);
+        Ring* R = Array.load(std::memory_order_relaxed);
+        if (B - T > R->Capacity - 1)
+        {
+            R = Grow(R, B, T);
+        }
+        R->Put(B, Handle.address());
+        Bottom.store(B + 1, std::memory_order_release);
+    }
+
+    // Pop the lastly pushed Handle from the bottom of the deque. Can be called only by the owning worker.
+    std::coroutine_handle<> Pop()
+    {
+        const int64_t B = Bottom.load(std::memory_order_relaxed) - 1;
+        Ring* R = Array.load(std::memory_order_relaxed);
+        Bottom.store(B, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t T = Top.load(std::memory_order_relaxed);
+
+        if (T > B)
+        {
+            // The deque was empty
+            Bottom.store(B + 1, std::memory_order_relaxed);
+            return {};
+        }
+
+        void* Item = R->Get(B);
+        if (T == B)
+        {
+            // This is the last item, so we have to race with thieves for it
+            if (Top.compare_exchange_strong(T, T + 1, std::memory_order_seq_cst, std::memory_order_relaxed) == false)
+            {
+                Item = nullptr;
+            }
+            Bottom.store(B + 1, std::memory_order_relaxed);
+        }
+        return std::coroutine_handle<>::from_address(Item);
+    }
+
+    // Steal the oldest Handle from the top of the deque. Can be called by any thread.
+    std::coroutine_handle<> Steal()
+    {
+        int64_t T = Top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t B = Bottom.load(std::memory_order_acquire);
+
+        if (T < B)
+        {
+            Ring* R = Array.load(std::memory_order_acquire);
+            void* Item = R->Get(T);
+            if (Top.compare_exchange_strong(T, T + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return std::coroutine_handle<>::from_address(Item);
+            }
+        }
+        return {};
+    }
+
+private:
+
+    // Circular buffer of Handle addresses. Capacity is always a power of two.
+    struct Ring
+    {
+        explicit Ring(int64_t InCapacity) :
+            Capacity(InCapacity),
+            Items(std::make_unique<std::atomic<void*>[]>(InCapacity))
+        {}
+
+        void* Get(int64_t Index) const { return Items[Index & (Capacity - 1)].load(std::memory_order_relaxed); }
+        void Put(int64_t Index, void* Item) { Items[Index & (Capacity - 1)].store(Item, std::memory_order_relaxed); }
+
+        const int64_t Capacity;
+        std::unique_ptr<std::atomic<void*>[]> Items;
+    };
+
+    // Create two times bigger buffer and copy all items to it. The old buffer is kept alive,
+    // because thieves might still be reading from it.
+    Ring* Grow(Ring* Old, int64_t B, int64_t T)
+    {
+        Rings.push_back(std::make_unique<Ring>(Old->Capacity * 2));
+        Ring* New = Rings.back().get();
+        for (int64_t i = T; i < B; i++)
+        {
+            New->Put(i, Old->Get(i));
+        }
+        Array.store(New, std::memory_order_release);
+        return New;
+    }
+
+    // Index of the oldest item, moved by thieves
+    alignas(64) std::atomic<int64_t> Top = 0;
+
+    // Index after the newest item, moved by the owner
+    alignas(64) std::atomic<int64_t> Bottom = 0;
+
+    // Currently used buffer
+    std::atomic<Ring*> Array;
+
+    // Every buffer ever allocated by this deque
+    std::vector<std::unique_ptr<Ring>> Rings;
+};
+
+// Thread pool which resumes coroutines on it's worker threads. Every worker has it's own deque.
+// When the worker has nothing to do it steals the work from the other workers.
+class CoroThreadPool
+{
+public:
+
+    // Awaiter which suspends the coroutine and resumes it on one of the workers
+    class ScheduleAwaiter
+    {
+    public:
+
+        explicit ScheduleAwaiter(CoroThreadPool& InPool) : Pool(InPool) {}
+
+        // Always suspend, so the coroutine can be moved to the pool
+        bool await_ready() const noexcept { return false; }
+
+        // Give the suspended coroutine to the pool
+        void await_suspend(std::coroutine_handle<> Handle) { Pool.Post(Handle); }
+
+        // Called when the coroutine has been resumed on the worker
+        void await_resume() const noexcept {}
+
+    private:
+
+        CoroThreadPool& Pool;
+    };
+
+    // Constructor - start the worker threads
+    explicit CoroThreadPool(unsigned NumWorkers = std::thread::hardware_concurrency())
+    {
+        if (NumWorkers == 0)
+        {
+            NumWorkers = 1;
+        }
+
+        Workers.reserve(NumWorkers);
+        for (unsigned i = 0; i < NumWorkers; i++)
+        {
+            Workers.push_back(std::make_unique<Worker>(i));
+        }
+        for (unsigned i = 0; i < NumWorkers; i++)
+        {
+            Workers[i]->Thread = std::thread([this, i]() { WorkerLoop(i); });
+        }
+    }
+
+    // Destructor - stop and join the worker threads. Coroutines which are still waiting in the pool are not resumed.
+    ~CoroThreadPool()
+    {
+        bStopping.store(true);
+        WakeEpoch.fetch_add(1);
+        WakeEpoch.notify_all();
+        for (std::unique_ptr<Worker>& W : Workers)
+        {
+            W->Thread.join();
+        }
+    }
+
+    // Use co_await Pool.Schedule() to continue the coroutine on the pool
+    ScheduleAwaiter Schedule() { return ScheduleAwaiter(*this); }
+
+    // Resume the given coroutine Handle on the pool. Can be called from any thread.
+    void Post(std::coroutine_handle<> Handle)
+    {
+        if (CurrentPool == this)
+        {
+            // Worker threads push to their own deque without any locking
+            Workers[CurrentWorkerIndex]->Deque.Push(Handle);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> Lock(InjectMutex);
+            InjectQueue.push_back(Handle);
+            NumInjected.fetch_add(1, std::memory_order_release);
+        }
+        Wake();
+    }
+
+    // Amount of worker threads
+    unsigned NumWorkers() const { return static_cast<unsigned>(Workers.size()); }
+
+private:
+
+    // Data of a single worker thread
+    struct Worker
+    {
+        explicit Worker(unsigned Index) : RandomState(Index * 2654435761u + 1u) {}
+
+        WorkStealingDeque Deque;
+        std::thread Thread;
+
+        // State of the random number generator used to pick the worker to steal from
+        uint32_t RandomState;
+    };
+
+    // Find the next coroutine to resume: own deque first, then the inject queue, then other workers
+    std::coroutine_handle<> FindWork(unsigned Index)
+    {
+        Worker& Self = *Workers[Index];
+        if (std::coroutine_handle<> Handle = Self.Deque.Pop())
+        {
+            return Handle;
+        }
+
+        if (NumInjected.load(std::memory_order_acquire) > 0)
+        {
+            std::lock_guard<std::mutex> Lock(InjectMutex);
+            if (InjectQueue.empty() == false)
+            {
+                std::coroutine_handle<> Handle = InjectQueue.front();
+                InjectQueue.pop_front();
+                NumInjected.fetch_sub(1, std::memory_order_relaxed);
+                return Handle;
+            }
+        }
+
+        // Start stealing from a random worker, so thieves don't fight over the same victim
+        Self.RandomState ^= Self.RandomState << 13;
+        Self.RandomState ^= Self.RandomState >> 17;
+        Self.RandomState ^= Self.RandomState << 5;
+        const unsigned Count = NumWorkers();
+        const unsigned Start = Self.RandomState % Count;
+        for (unsigned i = 0; i < Count; i++)
+        {
+            const unsigned Victim = (Start + i) % Count;
+            if (Victim != Index)
+            {
+                if (std::coroutine_handle<> Handle = Workers[Victim]->Deque.Steal())
+                {
+                    return Handle;
+                }
+            }
+        }
+        return {};
+    }
+
+    // Main loop of every worker thread
+    void WorkerLoop(unsigned Index)
+    {
+        CurrentPool = this;
+        CurrentWorkerIndex = Index;
+
+        while (bStopping.load(std::memory_order_relaxed) == false)
+        {
+            if (std::coroutine_handle<> Handle = FindWork(Index))
+            {
+                Handle.resume();
+                continue;
+            }
+
+            // Nothing to do. Announce that we are going to sleep, check the queues once again and sleep until the epoch changes.
+            NumSleeping.fetch_add(1);
+            const uint32_t Epoch = WakeEpoch.load();
+            if (std::coroutine_handle<> Handle = FindWork(Index))
+            {
+                NumSleeping.fetch_sub(1);
+                Handle.resume();
+                continue;
+            }
+            if (bStopping.load() == false)
+            {
+                WakeEpoch.wait(Epoch);
+            }
+            NumSleeping.fetch_sub(1);
+        }
+
+        CurrentPool = nullptr;
+    }
+
+    // Wake up one sleeping worker, if there is any
+    void Wake()
+    {
+        WakeEpoch.fetch_add(1);
+        if (NumSleeping.load() > 0)
+        {
+            WakeEpoch.notify_one();
+        }
+    }
+
+    // All workers of this pool
+    std::vector<std::unique_ptr<Worker>> Workers;
+
+    // Queue for coroutines posted from threads which are not workers of this pool
+    std::mutex InjectMutex;
+    std::deque<std::coroutine_handle<>> InjectQueue;
+    std::atomic<uint32_t> NumInjected = 0;
+
+    // Changed every time a new work is posted, sleeping workers wait for it's change
+    std::atomic<uint32_t> WakeEpoch = 0;
+
+    // Amount of workers which are going to sleep or are sleeping
+    std::atomic<uint32_t> NumSleeping = 0;
+
+    // Set when the pool is destroyed
+    std::atomic<bool> bStopping = false;
+
+    // Pool and index of the worker running on the current thread
+    static inline thread_local CoroThreadPool* CurrentPool = nullptr;
+    static inline thread_local unsigned CurrentWorkerIndex = 0;
+};
+
+// Forward declaration of the Task so it can be used inside the Promise
+template<typename T>
+class Task;
+
+// Common part of the Promise of every Task
+struct TaskPromiseBase
+{
+    // Awaiter used when the Task finishes. It transfers the execution directly to the awaiting coroutine.
+    struct FinalAwaiter
+    {
+        bool await_ready() noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> Handle) noexcept
+        {
+            return Handle.promise().Continuation;
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    // Coroutine which awaits this Task
+    std::coroutine_handle<> Continuation = std::noop_coroutine();
+
+    // Exception thrown inside the Task
+    std::exception_ptr Exception;
+
+    // Suspend the Task at the beginning, so it starts only when awaited
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    // Transfer the execution to the awaiting coroutine at the end
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    // Called when exception occurs. Remember it, so it can be rethrown later.
+    void unhandled_exception() { Exception = std::current_exception(); }
+};
+
+// Definition of the Task Promise which stores the result of a generic type
+template<typename T>
+struct TaskPromise : TaskPromiseBase
+{
+    std::optional<T> Value;
+
+    Task<T> get_return_object();
+
+    template<std::convertible_to<T> From>
+    void return_value(From&& from) { Value.emplace(std::forward<From>(from)); }
+
+    T GetResult()
+    {
+        if (Exception)
+        {
+            std::rethrow_exception(Exception);
+        }
+        return std::move(*Value);
+    }
+};
+
+// Definition of the Task Promise for Tasks which don't return anything
+template<>
+struct TaskPromise<void> : TaskPromiseBase
+{
+    Task<void> get_return_object();
+
+    void return_void() {}
+
+    void GetResult()
+    {
+        if (Exception)
+        {
+            std::rethrow_exception(Exception);
+        }
+    }
+};
+
+// Definition of the lazy Task, the same as in the 07_CoroLazyTasks.cpp sample
+template<typename T = void>
+class Task
+{
+public:
+
+    using promise_type = TaskPromise<T>;
+    using CoroHandle = std::coroutine_handle<promise_type>;
+
+    explicit Task(CoroHandle InHandle) : Handle(InHandle) {}
+    Task(Task&& Other) noexcept : Handle(std::exchange(Other.Handle, {})) {}
+    Task& operator=(Task&& Other) noexcept
+    {
+        if (this != &Other)
+        {
+            if (Handle)
+            {
+                Handle.destroy();
+            }
+            Handle = std::exchange(Other.Handle, {});
+        }
+        return *this;
+    }
+    ~Task()
+    {
+        if (Handle)
+        {
+            Handle.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return !Handle || Handle.done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> Awaiting) noexcept
+    {
+        Handle.promise().Continuation = Awaiting;
+        return Handle;
+    }
+
+    T await_resume() { return Handle.promise().GetResult(); }
+
+    void Start() { Handle.resume(); }
+    bool IsDone() const { return Handle.done(); }
+    T GetResult() { return Handle.promise().GetResult(); }
+
+private:
+
+    CoroHandle Handle;
+};
+
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object() { return Task<T>(Task<T>::CoroHandle::from_promise(*this)); }
+
+inline Task<void> TaskPromise<void>::get_return_object() { return Task<void>(Task<void>::CoroHandle::from_promise(*this)); }
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the fire and forget coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    using promise_type = ::CoroPromise;
+};
+
+// Definition of the fire and forget coroutine Promise
+struct CoroPromise
+{
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() {}
+};
+
+// CPU heavy Task which moves itself to the pool before doing the work
+Task<uint64_t> SumTask(CoroThreadPool& Pool, uint64_t From, uint64_t To)
+{
+    co_await Pool.Schedule();
+
+    uint64_t Sum = 0;
+    for (uint64_t i = From; i < To; i++)
+    {
+        Sum += i;
+    }
+    co_return Sum;
+}
+
+// Fire and forget coroutine which awaits the Task and stores it's result
+CoroHandle JobCoroutine(CoroThreadPool& Pool, uint64_t Index, std::atomic<uint64_t>& Total, std::atomic<int>& NumOnMainThread, std::latch& Done)
+{
+    const std::thread::id MainThread = std::this_thread::get_id();
+
+    const uint64_t Sum = co_await SumTask(Pool, Index * 1000000, (Index + 1) * 1000000);
+    if (std::this_thread::get_id() == MainThread)
+    {
+        NumOnMainThread++;
+    }
+
+    Total += Sum;
+    Done.count_down();
+}
+
+// Main program
+int main()
+{
+    constexpr int NumJobs = 64;
+
+    std::atomic<uint64_t> Total = 0;
+    std::atomic<int> NumOnMainThread = 0;
+    std::latch Done(NumJobs);
+
+    // The pool is declared as the last one, so it's workers are joined before the results and the latch are destroyed
+    CoroThreadPool Pool;
+
+    // Every job starts on the main thread and continues on the pool
+    for (int i = 0; i < NumJobs; i++)
+    {
+        JobCoroutine(Pool, i, Total, NumOnMainThread, Done);
+    }
+
+    // Wait until every job has finished
+    Done.wait();
+
+    std::cout << "Total: " << Total.load() << "\n";
+    std::cout << "Jobs finished on the main thread: " << NumOnMainThread.load() << "\n";
+
+    return 0;
+}
+
+/**
+ The program should output:
+
+ Total: 2047999968000000
+ Jobs finished on the main thread: 0
+*/
@@ -0,0 +1,212 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutines which are resumed on their owning thread after being completed on other threads.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Node of the ready queue. It is embedded inside the awaiter, so pushing a coroutine to the queue doesn't allocate anything.
+struct CoroReadyNode
+{
+    // Next node in the queue
+    CoroReadyNode* Next = nullptr;
+
+    // Coroutine to resume when the node is popped from the queue
+    std::coroutine_handle<> Handle;
+};
+
+// Lock-free multi-producer single-consumer queue of coroutines ready to be resumed.
+// Any thread can push to it, but only the owning thread should drain it.
+class CoroReadyQueue
+{
+public:
+
+    // Push the node to the queue. Can be called from any thread.
+    void Push(CoroReadyNode* Node)
+    {
+        // The node can't be touched after it has been pushed, because the owning thread might already resume it
+        CoroReadyNode* OldHead = Head.load(std::memory_order_relaxed);
+        do
+        {
+            Node->Next = OldHead;
+        }
+        while (Head.compare_exchange_weak(OldHead, Node, std::memory_order_release, std::memory_order_relaxed) == false);
+
+        // Wake the owning thread only if the queue was empty, otherwise it has been already woken
+        if (OldHead == nullptr)
+        {
+            Head.notify_one();
+        }
+    }
+
+    // Take all queued nodes at once and resume their coroutines in the order they were pushed.
+    // Returns the amount of resumed coroutines. Must be called only by the owning thread.
+    std::size_t Drain()
+    {
+        // Pushing makes the newest node the head, so the taken list must be reversed to keep the order
+        CoroReadyNode* List = Head.exchange(nullptr, std::memory_order_acquire);
+        CoroReadyNode* Reversed = nullptr;
+        while (List)
+        {
+            CoroReadyNode* Next = List->Next;
+            List->Next = Reversed;
+            Reversed = List;
+            List = Next;
+        }
+
+        std::size_t Count = 0;
+        while (Reversed)
+        {
+            // Read the next node before resuming, because the resumed coroutine destroys the awaiter which holds the node
+            CoroReadyNode* Next = Reversed->Next;
+            Reversed->Handle.resume();
+            Reversed = Next;
+            Count++;
+        }
+        return Count;
+    }
+
+    // Block the owning thread until something is pushed to the queue
+    void Wait() const
+    {
+        Head.wait(nullptr, std::memory_order_acquire);
+    }
+
+private:
+
+    // The lastly pushed node
+    std::atomic<CoroReadyNode*> Head = nullptr;
+};
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroPromise;
+};
+
+// Definition of the coroutine Promise
+struct CoroPromise
+{
+    // Called in order to construct the coroutine Handle
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+
+    // Do not suspend when the coroutine starts
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    // Do not suspend when the coroutine ends
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs
+    void unhandled_exception() {}
+};
+
+// Definition of the coroutine Task which computes a value on a background thread. Instead of resuming
+// the coroutine on the background thread it hands it off to the ready queue of the owning thread.
+class BackgroundSquareTask : private CoroReadyNode
+{
+private:
+
+    // Queue of the thread which should resume the coroutine
+    CoroReadyQueue& Queue;
+
+    // Threads doing the background work
+    std::vector<std::jthread>& Threads;
+
+    // Value to compute
+    int Value;
+
+    // Computed result
+    int Result = 0;
+
+public:
+
+    // Task constructor which stores the queue to resume on and the value to compute
+    BackgroundSquareTask(CoroReadyQueue& InQueue, std::vector<std::jthread>& InThreads, int InValue) :
+        Queue(InQueue),
+        Threads(InThreads),
+        Value(InValue)
+    {}
+
+    // Called when the coroutine has been resumed, returns the computed result
+    int await_resume() { return Result; }
+
+    // Indicated that coroutine can be suspended
+    bool await_ready() { return false; }
+
+    // Called when the coroutine has been suspended using this Task
+    void await_suspend(std::coroutine_handle<CoroPromise> CoroHandle)
+    {
+        Handle = CoroHandle;
+        Threads.emplace_back([this]()
+        {
+            Result = Value * Value;
+
+            // Completion on the background thread costs only one push to the queue
+            Queue.Push(this);
+        });
+    }
+};
+
+// Definition of the coroutine function which waits for the background work
+CoroHandle SquareCoroutine(CoroReadyQueue& Queue, std::vector<std::jthread>& Threads, int Value, int& Sum, int& NumOnMainThread)
+{
+    const std::thread::id MainThread = std::this_thread::get_id();
+
+    const int Result = co_await BackgroundSquareTask(Queue, Threads, Value);
+    if (std::this_thread::get_id() == MainThread)
+    {
+        NumOnMainThread++;
+    }
+    Sum += Result;
+}
+
+// Main program
+int main()
+{
+    constexpr int NumCoroutines = 10;
+
+    CoroReadyQueue Queue;
+    std::vector<std::jthread> Threads;
+    Threads.reserve(NumCoroutines);
+
+    // Start the coroutines. Every coroutine suspends and waits for the background thread.
+    // Sum and NumOnMainThread are touched only on the main thread, so they don't need to be atomic.
+    int Sum = 0;
+    int NumOnMainThread = 0;
+    for (int i = 1; i <= NumCoroutines; i++)
+    {
+        SquareCoroutine(Queue, Threads, i, Sum, NumOnMainThread);
+    }
+
+    // The main loop of the owning thread. It sleeps until something is pushed and resumes the whole batch at once.
+    std::size_t NumResumed = 0;
+    while (NumResumed < NumCoroutines)
+    {
+        Queue.Wait();
+        NumResumed += Queue.Drain();
+    }
+
+    std::cout << "Sum: " << Sum << "\n";
+    std::cout << "Resumed on the main thread: " << NumOnMainThread << "\n";
+
+    return 0;
+}
+
+/**
+ The program should output:
+
+ Sum: 385
+ Resumed on the main thread: 10
+*/
@@ -0,0 +1,355 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the set of microbenchmarks measuring the cost of the basic coroutine operations.
+// It uses Google Benchmark: https://github.com/google/benchmark
+// Compile it with optimizations enabled, for example: g++ -std=c++20 -O2 11_CoroBenchmarks.cpp -lbenchmark -lpthread
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Amount of coroutine frames allocated by the promises below. Used to check if the compiler has elided the allocation.
+static std::size_t NumFrameAllocations = 0;
+
+// Base for every Promise which should count it's frame allocations
+struct CountedFrame
+{
+    static void* operator new(std::size_t Size)
+    {
+        NumFrameAllocations++;
+        return ::operator new(Size);
+    }
+
+    static void operator delete(void* Ptr, std::size_t Size)
+    {
+        ::operator delete(Ptr, Size);
+    }
+};
+
+// Coroutine which is suspended at the beginning and destroyed by it's owner. Used to measure resume and frame cost.
+struct LazyCoro
+{
+    struct CoroPromise;
+    using promise_type = CoroPromise;
+    using CoroHandle = std::coroutine_handle<CoroPromise>;
+
+    struct CoroPromise : CountedFrame
+    {
+        LazyCoro get_return_object() { return LazyCoro(CoroHandle::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() {}
+    };
+
+    explicit LazyCoro(CoroHandle InHandle) : Handle(InHandle) {}
+    LazyCoro(LazyCoro&& Other) noexcept : Handle(std::exchange(Other.Handle, {})) {}
+    LazyCoro(const LazyCoro&) = delete;
+    LazyCoro& operator=(const LazyCoro&) = delete;
+    ~LazyCoro()
+    {
+        if (Handle)
+        {
+            Handle.destroy();
+        }
+    }
+
+    CoroHandle Handle;
+};
+
+// Generator yielding values by pointer, the same as in the 03_CoroGenerators.cpp sample
+template<typename T>
+struct CoroGenerator
+{
+    struct CoroPromise;
+    using promise_type = CoroPromise;
+    using CoroHandle = std::coroutine_handle<CoroPromise>;
+
+    struct CoroPromise : CountedFrame
+    {
+        const T* Value = nullptr;
+
+        CoroGenerator get_return_object() { return CoroGenerator(CoroHandle::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() {}
+
+        std::suspend_always yield_value(const T& from)
+        {
+            Value = std::addressof(from);
+            return {};
+        }
+    };
+
+    class Iterator
+    {
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+        explicit Iterator(CoroHandle InHandle) : Handle(InHandle) {}
+
+        const T& operator*() const { return *Handle.promise().Value; }
+        Iterator& operator++()
+        {
+            Handle.resume();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+        bool operator==(std::default_sentinel_t) const { return Handle.done(); }
+
+    private:
+        CoroHandle Handle;
+    };
+
+    Iterator begin()
+    {
+        Handle.resume();
+        return Iterator(Handle);
+    }
+    std::default_sentinel_t end() { return {}; }
+
+    explicit CoroGenerator(CoroHandle InHandle) : Handle(InHandle) {}
+    CoroGenerator(const CoroGenerator&) = delete;
+    CoroGenerator& operator=(const CoroGenerator&) = delete;
+    ~CoroGenerator() { Handle.destroy(); }
+
+private:
+    CoroHandle Handle;
+};
+
+// Timer queue driven by a manual clock, similar to the CoroTimerQueue from the 06_CoroUE5TimerQueue.cpp sample
+class ManualTimerQueue
+{
+public:
+
+    // Awaiter suspending the coroutine for the given amount of ticks
+    struct WaitTicksTask
+    {
+        ManualTimerQueue& Queue;
+        uint64_t Ticks;
+
+        bool await_ready() const noexcept { return Ticks == 0; }
+        void await_suspend(std::coroutine_handle<> Handle) { Queue.Add(Ticks, Handle); }
+        void await_resume() const noexcept {}
+    };
+
+    WaitTicksTask WaitTicks(uint64_t Ticks) { return { *this, Ticks }; }
+
+    // Advance the clock by one tick and resume every expired coroutine
+    void Tick()
+    {
+        CurrentTick++;
+        while (Timers.empty() == false && Timers.front().Deadline <= CurrentTick)
+        {
+            std::pop_heap(Timers.begin(), Timers.end(), Later);
+            const std::coroutine_handle<> Handle = Timers.back().Handle;
+            Timers.pop_back();
+            Handle.resume();
+            NumResumed++;
+        }
+    }
+
+    // Amount of coroutines resumed by all ticks so far
+    uint64_t GetNumResumed() const { return NumResumed; }
+
+private:
+
+    struct Timer
+    {
+        uint64_t Deadline;
+        std::coroutine_handle<> Handle;
+    };
+
+    static bool Later(const Timer& A, const Timer& B) { return A.Deadline > B.Deadline; }
+
+    void Add(uint64_t Ticks, std::coroutine_handle<> Handle)
+    {
+        Timers.push_back({ CurrentTick + Ticks, Handle });
+        std::push_heap(Timers.begin(), Timers.end(), Later);
+    }
+
+    uint64_t CurrentTick = 0;
+    uint64_t NumResumed = 0;
+    std::vector<Timer> Timers;
+};
+
+// Coroutine which suspends forever
+LazyCoro SuspendLoop()
+{
+    for (;;)
+    {
+        co_await std::suspend_always();
+    }
+}
+
+// Coroutine which does nothing
+LazyCoro EmptyCoro()
+{
+    co_return;
+}
+
+// Generator which yields numbers from 0 to Amount - 1
+CoroGenerator<int64_t> CountGenerator(int64_t Amount)
+{
+    for (int64_t i = 0; i < Amount; i++)
+    {
+        co_yield i;
+    }
+}
+
+// Callback based equivalent of the CountGenerator
+void CountCallback(int64_t Amount, const std::function<void(int64_t)>& Callback)
+{
+    for (int64_t i = 0; i < Amount; i++)
+    {
+        Callback(i);
+    }
+}
+
+// Coroutine which waits on the timer queue for the given amount of ticks in a loop
+LazyCoro TimerLoop(ManualTimerQueue& Queue, uint64_t Ticks)
+{
+    for (;;)
+    {
+        co_await Queue.WaitTicks(Ticks);
+    }
+}
+
+// Report how many frames have been allocated per iteration. 0 means the allocation has been elided.
+static void ReportAllocations(benchmark::State& State, std::size_t AllocationsBefore)
+{
+    State.counters["FramesPerIter"] = benchmark::Counter(
+        static_cast<double>(NumFrameAllocations - AllocationsBefore),
+        benchmark::Counter::kAvgIterations);
+}
+
+// Cost of a single resume and suspend of already existing coroutine
+static void BM_ResumeSuspend(benchmark::State& State)
+{
+    LazyCoro Coro = SuspendLoop();
+    for (auto _ : State)
+    {
+        Coro.Handle.resume();
+    }
+}
+BENCHMARK(BM_ResumeSuspend);
+
+// Cost of creating, running and destroying a coroutine which frame escapes, so it must be allocated
+static void BM_FrameEscaping(benchmark::State& State)
+{
+    const std::size_t AllocationsBefore = NumFrameAllocations;
+    for (auto _ : State)
+    {
+        LazyCoro Coro = EmptyCoro();
+        benchmark::DoNotOptimize(Coro.Handle);
+        Coro.Handle.resume();
+    }
+    ReportAllocations(State, AllocationsBefore);
+}
+BENCHMARK(BM_FrameEscaping);
+
+// Cost of creating, running and destroying a coroutine which lifetime is known to the compiler,
+// so it can elide the heap allocation (HALO). Clang does it, GCC and MSVC usually don't.
+static void BM_FrameElidable(benchmark::State& State)
+{
+    const std::size_t AllocationsBefore = NumFrameAllocations;
+    for (auto _ : State)
+    {
+        LazyCoro Coro = EmptyCoro();
+        Coro.Handle.resume();
+    }
+    ReportAllocations(State, AllocationsBefore);
+}
+BENCHMARK(BM_FrameElidable);
+
+// Throughput of the coroutine Generator
+static void BM_GeneratorCoroutine(benchmark::State& State)
+{
+    const int64_t Amount = State.range(0);
+    for (auto _ : State)
+    {
+        int64_t Sum = 0;
+        for (const int64_t Value : CountGenerator(Amount))
+        {
+            Sum += Value;
+        }
+        benchmark::DoNotOptimize(Sum);
+    }
+    State.SetItemsProcessed(State.iterations() * Amount);
+}
+BENCHMARK(BM_GeneratorCoroutine)->Arg(1 << 16);
+
+// Throughput of the hand written loop doing the same as the Generator
+static void BM_GeneratorHandLoop(benchmark::State& State)
+{
+    const int64_t Amount = State.range(0);
+    for (auto _ : State)
+    {
+        int64_t Sum = 0;
+        for (int64_t i = 0; i < Amount; i++)
+        {
+            benchmark::DoNotOptimize(i);
+            Sum += i;
+        }
+        benchmark::DoNotOptimize(Sum);
+    }
+    State.SetItemsProcessed(State.iterations() * Amount);
+}
+BENCHMARK(BM_GeneratorHandLoop)->Arg(1 << 16);
+
+// Throughput of the callback based iteration doing the same as the Generator
+static void BM_GeneratorCallback(benchmark::State& State)
+{
+    const int64_t Amount = State.range(0);
+    for (auto _ : State)
+    {
+        int64_t Sum = 0;
+        CountCallback(Amount, [&Sum](int64_t Value) { Sum += Value; });
+        benchmark::DoNotOptimize(Sum);
+    }
+    State.SetItemsProcessed(State.iterations() * Amount);
+}
+BENCHMARK(BM_GeneratorCallback)->Arg(1 << 16);
+
+// Overhead of waiting on the timer queue with the given amount of waiting coroutines. The time is measured per tick,
+// and the items processed are the resumed waits, so items_per_second gives the cost of a single wait.
+static void BM_TimerWait(benchmark::State& State)
+{
+    const int64_t NumWaiting = State.range(0);
+    ManualTimerQueue Queue;
+    std::vector<LazyCoro> Coros;
+    Coros.reserve(NumWaiting);
+    for (int64_t i = 0; i < NumWaiting; i++)
+    {
+        // Every coroutine waits for a different amount of ticks, so only some of them expire in each tick
+        Coros.push_back(TimerLoop(Queue, 1 + i % 16));
+        Coros.back().Handle.resume();
+    }
+
+    const uint64_t ResumedBefore = Queue.GetNumResumed();
+    for (auto _ : State)
+    {
+        Queue.Tick();
+    }
+
+    // Every tick resumes only some of the coroutines, so the items are the resumed waits, not the ticks
+    State.SetItemsProcessed(static_cast<int64_t>(Queue.GetNumResumed() - ResumedBefore));
+}
+BENCHMARK(BM_TimerWait)->Arg(16)->Arg(1024)->Arg(65536);
+
+BENCHMARK_MAIN();
+
+/**
+ The program outputs the Google Benchmark table. The actual numbers depend on the hardware and the compiler.
+*/
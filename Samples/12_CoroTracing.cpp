@@ -0,0 +1,381 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutines which record their lifetime for profiling.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <source_location>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Set to 0 to compile out the tracing completely. The traced Promise becomes an empty struct then.
+#ifndef CORO_TRACING
+#define CORO_TRACING 1
+#endif
+
+// Set to 1 inside Unreal Engine to send every coroutine run to Unreal Insights as a CPU profiler event
+#ifndef CORO_TRACING_UNREAL_INSIGHTS
+#define CORO_TRACING_UNREAL_INSIGHTS 0
+#endif
+
+#if CORO_TRACING_UNREAL_INSIGHTS
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#endif
+
+#if CORO_TRACING
+
+// Single period of time during which the coroutine was running, from the start or a resume until the next suspension or the end
+struct CoroTraceSlice
+{
+    // Name of the coroutine function
+    const char* Name;
+
+    // Unique id of the coroutine
+    uint64_t CoroId;
+
+    // Size of the coroutine frame in bytes
+    std::size_t FrameSize;
+
+    // Thread the coroutine was running on
+    uint32_t ThreadId;
+
+    // Line of the co_await which has resumed the coroutine, or 0 when the coroutine has just started
+    uint32_t ResumedAtLine;
+
+    // Time the coroutine was running, in microseconds since the tracer has been created
+    int64_t StartUs;
+    int64_t DurationUs;
+
+    // Time the coroutine had been suspended before this slice started
+    int64_t SuspendedUs;
+};
+
+// Collects slices of all traced coroutines and exports them
+class CoroTracer
+{
+public:
+
+    // Get the one and only tracer
+    static CoroTracer& Get()
+    {
+        static CoroTracer Tracer;
+        return Tracer;
+    }
+
+    // Current time in microseconds since the tracer has been created
+    int64_t NowUs() const
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - StartTime).count();
+    }
+
+    // Small, readable id of the calling thread
+    static uint32_t GetThreadId()
+    {
+        static std::atomic<uint32_t> NextThreadId = 0;
+        thread_local const uint32_t ThreadId = NextThreadId++;
+        return ThreadId;
+    }
+
+    // Get a new unique coroutine id
+    uint64_t NewCoroId() { return NextCoroId++; }
+
+    // Store the finished slice
+    void AddSlice(const CoroTraceSlice& Slice)
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Slices.push_back(Slice);
+    }
+
+    // Amount of recorded slices
+    std::size_t NumSlices()
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        return Slices.size();
+    }
+
+    // Write all recorded slices in the Chrome trace event format. The file can be opened in chrome://tracing or https://ui.perfetto.dev
+    void WriteChromeTrace(std::ostream& Out)
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Out << "{\"traceEvents\":[\n";
+        for (std::size_t i = 0; i < Slices.size(); i++)
+        {
+            const CoroTraceSlice& Slice = Slices[i];
+            Out << "{\"name\":\"";
+            WriteEscaped(Out, Slice.Name);
+            Out << "\",\"cat\":\"coro\",\"ph\":\"X\",\"pid\":0"
+                << ",\"tid\":" << Slice.ThreadId
+                << ",\"ts\":" << Slice.StartUs
+                << ",\"dur\":" << Slice.DurationUs
+                << ",\"args\":{\"coro\":" << Slice.CoroId
+                << ",\"frame_size\":" << Slice.FrameSize
+                << ",\"resumed_at_line\":" << Slice.ResumedAtLine
+                << ",\"suspended_us\":" << Slice.SuspendedUs
+                << "}}" << (i + 1 < Slices.size() ? ",\n" : "\n");
+        }
+        Out << "]}\n";
+    }
+
+private:
+
+    // Function names can contain characters which must be escaped in JSON
+    static void WriteEscaped(std::ostream& Out, const char* Text)
+    {
+        for (; *Text; Text++)
+        {
+            if (*Text == '"' || *Text == '\\')
+            {
+                Out << '\\';
+            }
+            Out << *Text;
+        }
+    }
+
+    const std::chrono::steady_clock::time_point StartTime = std::chrono::steady_clock::now();
+    std::atomic<uint64_t> NextCoroId = 0;
+    std::mutex Mutex;
+    std::vector<CoroTraceSlice> Slices;
+};
+
+// Base for every Promise which should be traced. It hooks into the frame allocation, every co_await and the destruction.
+struct CoroTracedPromise
+{
+    // Called when the coroutine frame is created. Remember it's size, so the Promise constructor can read it.
+    static void* operator new(std::size_t Size)
+    {
+        PendingFrameSize = Size;
+        return ::operator new(Size);
+    }
+
+    // Called when the coroutine frame is destroyed
+    static void operator delete(void* Ptr, std::size_t Size)
+    {
+        ::operator delete(Ptr, Size);
+    }
+
+    // Called when the coroutine is created with the location of the coroutine function, which gives us it's name
+    explicit CoroTracedPromise(std::source_location Location) :
+        Name(Location.function_name()),
+        CoroId(CoroTracer::Get().NewCoroId()),
+        FrameSize(PendingFrameSize)
+    {
+        BeginSlice(0, 0, CoroTracer::Get().NowUs());
+    }
+
+    // Called when the coroutine is destroyed. Ends the last slice if the coroutine was running.
+    ~CoroTracedPromise()
+    {
+        if (bRunning)
+        {
+            EndSlice(CoroTracer::Get().NowUs());
+        }
+    }
+
+    // Awaiter wrapping every awaiter used with co_await inside the traced coroutine
+    template<typename Awaiter>
+    struct TracedAwaiter
+    {
+        Awaiter Inner;
+        CoroTracedPromise& Promise;
+        uint32_t Line;
+        int64_t SuspendedAt = 0;
+
+        bool await_ready() { return Inner.await_ready(); }
+
+        // The slice must end before the inner await_suspend is called, because it might resume the coroutine on another thread.
+        // The time is taken once, before the tracer records the slice, so the cost of the tracer is not counted as running.
+        template<typename HandlePromise>
+        auto await_suspend(std::coroutine_handle<HandlePromise> Handle)
+        {
+            SuspendedAt = CoroTracer::Get().NowUs();
+            Promise.EndSlice(SuspendedAt);
+            return Inner.await_suspend(Handle);
+        }
+
+        // Called on the thread which resumes the coroutine, so the new slice is recorded on that thread
+        decltype(auto) await_resume()
+        {
+            if (Promise.bRunning == false)
+            {
+                const int64_t Now = CoroTracer::Get().NowUs();
+                Promise.BeginSlice(Line, Now - SuspendedAt, Now);
+            }
+            return Inner.await_resume();
+        }
+    };
+
+    // Called for every co_await inside the coroutine. The default argument gives us the line of the co_await.
+    // The awaiter is obtained the same way the compiler does it: from the operator co_await if there is one, or the awaitable itself.
+    // Temporary awaiters are kept inside the TracedAwaiter, the other ones are referenced.
+    template<typename Awaitable>
+    auto await_transform(Awaitable&& Value, std::source_location Location = std::source_location::current())
+    {
+        using Awaiter = decltype(GetAwaiter(std::forward<Awaitable>(Value)));
+        using StoredAwaiter = std::conditional_t<std::is_rvalue_reference_v<Awaiter>, std::remove_cvref_t<Awaiter>, Awaiter>;
+        return TracedAwaiter<StoredAwaiter>{ GetAwaiter(std::forward<Awaitable>(Value)), *this, Location.line() };
+    }
+
+private:
+
+    // Awaitables which provide the operator co_await as a member or as a free function
+    template<typename T>
+    static constexpr bool HasMemberCoAwait = requires(T&& Value) { std::forward<T>(Value).operator co_await(); };
+    template<typename T>
+    static constexpr bool HasFreeCoAwait = requires(T&& Value) { operator co_await(std::forward<T>(Value)); };
+
+    // Get the awaiter of the given awaitable
+    template<typename Awaitable>
+    static decltype(auto) GetAwaiter(Awaitable&& Value)
+    {
+        if constexpr (HasMemberCoAwait<Awaitable>)
+        {
+            return std::forward<Awaitable>(Value).operator co_await();
+        }
+        else if constexpr (HasFreeCoAwait<Awaitable>)
+        {
+            return operator co_await(std::forward<Awaitable>(Value));
+        }
+        else
+        {
+            return std::forward<Awaitable>(Value);
+        }
+    }
+
+    // Start the slice on the current thread at the given time
+    void BeginSlice(uint32_t ResumedAtLine, int64_t SuspendedUs, int64_t StartUs)
+    {
+        bRunning = true;
+        Slice = { Name, CoroId, FrameSize, CoroTracer::GetThreadId(), ResumedAtLine, StartUs, 0, SuspendedUs };
+#if CORO_TRACING_UNREAL_INSIGHTS
+        FCpuProfilerTrace::OutputBeginDynamicEvent(Name);
+#endif
+    }
+
+    // Finish the slice at the given time and give it to the tracer
+    void EndSlice(int64_t EndUs)
+    {
+#if CORO_TRACING_UNREAL_INSIGHTS
+        FCpuProfilerTrace::OutputEndEvent();
+#endif
+        bRunning = false;
+        Slice.DurationUs = EndUs - Slice.StartUs;
+        CoroTracer::Get().AddSlice(Slice);
+    }
+
+    // Frame size given to the lastly called operator new on this thread
+    static inline thread_local std::size_t PendingFrameSize = 0;
+
+    const char* Name;
+    uint64_t CoroId;
+    std::size_t FrameSize;
+    bool bRunning = false;
+    CoroTraceSlice Slice = {};
+};
+
+#else
+
+// Tracing is disabled, so the traced Promise adds nothing to the coroutine
+struct CoroTracedPromise
+{
+    explicit CoroTracedPromise(std::source_location) {}
+};
+
+#endif
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroPromise;
+
+    // Called when the coroutine has been resumed
+    void await_resume() {}
+
+    // Indicated that coroutine can be suspended
+    bool await_ready() { return false; }
+
+    // Called when the coroutine has been suspended
+    void await_suspend(std::coroutine_handle<CoroPromise> Handle) {};
+};
+
+// Definition of the traced coroutine Promise
+struct CoroPromise : CoroTracedPromise
+{
+    // Called when the coroutine is created. The default argument is evaluated inside the coroutine function,
+    // so it gives the traced Promise the name of the coroutine.
+    CoroPromise(std::source_location Location = std::source_location::current()) : CoroTracedPromise(Location) {}
+
+    // Called in order to construct the coroutine Handle
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+
+    // Do not suspend when the coroutine starts
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    // Do not suspend when the coroutine ends
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs
+    void unhandled_exception() {}
+};
+
+// Definition of the coroutine function which is suspended twice and does some heavy work in between
+CoroHandle CoroHeavyWork(uint64_t& Result)
+{
+    co_await CoroHandle();
+
+    // This part hogs the thread which resumed the coroutine and it will be clearly visible in the trace
+    for (uint64_t i = 0; i < 10000000; i++)
+    {
+        Result += i % 7;
+    }
+
+    co_await CoroHandle();
+}
+
+// Main program
+int main()
+{
+    uint64_t Result = 0;
+
+    // The coroutine starts on the main thread and suspends
+    CoroHandle handle = CoroHeavyWork(Result);
+
+    // Resume the coroutine on another thread. The heavy part will be recorded on this thread.
+    std::thread([handle]() { handle.resume(); }).join();
+
+    // Resume the coroutine again on the main thread, so it can finish
+    handle.resume();
+
+#if CORO_TRACING
+    std::cout << "Recorded slices: " << CoroTracer::Get().NumSlices() << "\n";
+
+    std::ofstream File("coro_trace.json");
+    CoroTracer::Get().WriteChromeTrace(File);
+    std::cout << "Trace written to coro_trace.json\n";
+#endif
+
+    return 0;
+}
+
+/**
+ The program should output (with CORO_TRACING enabled):
+
+ Recorded slices: 3
+ Trace written to coro_trace.json
+*/
@@ -0,0 +1,451 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutines waiting for asynchronous file and socket operations on Linux.
+// It uses io_uring (through liburing) when it is available and epoll otherwise. If io_uring is compiled in,
+// but blocked at runtime (like in many containers), the epoll backend is used instead.
+// Compile it with: g++ -std=c++20 13_CoroAsyncIO.cpp -luring (or without -luring for the epoll version)
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <cerrno>
+#include <coroutine>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Set to 0 to use epoll even if liburing is available
+#ifndef CORO_IO_URING
+#if __has_include(<liburing.h>)
+#define CORO_IO_URING 1
+#else
+#define CORO_IO_URING 0
+#endif
+#endif
+
+#if CORO_IO_URING
+#include <liburing.h>
+#endif
+#include <sys/epoll.h>
+
+// Event loop which runs asynchronous operations and resumes the coroutines waiting for them.
+// It should be used from one thread only.
+class CoroIoContext
+{
+public:
+
+    // Kind of the asynchronous operation
+    enum class EIoOp
+    {
+        Read,
+        Write,
+        Accept
+    };
+
+    // Backend used by the context, chosen at runtime, because io_uring can be compiled in, but blocked by the system
+    enum class EIoBackend
+    {
+        None,
+        IoUring,
+        Epoll
+    };
+
+    // Awaiter of a single asynchronous operation. It lives inside the suspended coroutine frame,
+    // so the event loop can refer to it directly, without any allocation.
+    class IoAwaiter
+    {
+    public:
+
+        IoAwaiter(CoroIoContext& InContext, EIoOp InOp, int InFd, void* InBuffer, std::size_t InSize) :
+            Context(InContext),
+            Op(InOp),
+            Fd(InFd),
+            Buffer(InBuffer),
+            Size(InSize)
+        {}
+
+        // With io_uring always suspend, the operation will be submitted together with the other ones queued in this loop iteration.
+        // With epoll try the operation right away and suspend only if it would block.
+        bool await_ready() noexcept
+        {
+            if (Context.Backend == EIoBackend::IoUring)
+            {
+                return false;
+            }
+            Result = Perform();
+            return Result != -EAGAIN && Result != -EWOULDBLOCK;
+        }
+
+        // Queue the submission for the operation or wait until the file descriptor is ready.
+        // If that fails the coroutine is not suspended and the error is returned from the co_await.
+        bool await_suspend(std::coroutine_handle<> InHandle)
+        {
+            Handle = InHandle;
+            Result = Context.Backend == EIoBackend::IoUring ? Context.Submit(this) : Context.Arm(this);
+            return Result == 0;
+        }
+
+        // Returns the amount of transferred bytes or the accepted socket. Negative value is the -errno of the failed operation.
+        int await_resume() const noexcept { return Result; }
+
+    private:
+
+        friend class CoroIoContext;
+
+        // Perform the non-blocking system call
+        int Perform()
+        {
+            int Ret = -1;
+            switch (Op)
+            {
+                case EIoOp::Read: Ret = static_cast<int>(::read(Fd, Buffer, Size)); break;
+                case EIoOp::Write: Ret = static_cast<int>(::write(Fd, Buffer, Size)); break;
+                case EIoOp::Accept: Ret = ::accept4(Fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC); break;
+            }
+            return Ret < 0 ? -errno : Ret;
+        }
+
+        CoroIoContext& Context;
+        EIoOp Op;
+        int Fd;
+        void* Buffer;
+        std::size_t Size;
+        int Result = 0;
+        std::coroutine_handle<> Handle;
+    };
+
+    // Constructor - create the io_uring instance, or the epoll one if io_uring is not compiled in or it is blocked by the system
+    explicit CoroIoContext(unsigned QueueDepth = 256)
+    {
+#if CORO_IO_URING
+        const int Ret = io_uring_queue_init(QueueDepth, &Ring, 0);
+        if (Ret == 0)
+        {
+            Backend = EIoBackend::IoUring;
+            return;
+        }
+        if (Ret != -ENOSYS && Ret != -EPERM)
+        {
+            Error = Ret;
+            return;
+        }
+#else
+        (void)QueueDepth;
+#endif
+        EpollFd = ::epoll_create1(EPOLL_CLOEXEC);
+        if (EpollFd < 0)
+        {
+            Error = -errno;
+            return;
+        }
+        Backend = EIoBackend::Epoll;
+    }
+
+    // Destructor - release the io_uring or the epoll instance
+    ~CoroIoContext()
+    {
+#if CORO_IO_URING
+        if (Backend == EIoBackend::IoUring)
+        {
+            io_uring_queue_exit(&Ring);
+        }
+#endif
+        if (EpollFd >= 0)
+        {
+            ::close(EpollFd);
+        }
+    }
+
+    // Backend chosen by the constructor
+    EIoBackend GetBackend() const { return Backend; }
+
+    // The -errno of the failed creation of the context, or 0 if it can be used
+    int GetError() const { return Error; }
+
+    CoroIoContext(const CoroIoContext&) = delete;
+    CoroIoContext& operator=(const CoroIoContext&) = delete;
+
+    // Use co_await Context.AsyncRead(Fd, Buffer) to read from the file or socket
+    IoAwaiter AsyncRead(int Fd, std::span<std::byte> Buffer)
+    {
+        return IoAwaiter(*this, EIoOp::Read, Fd, Buffer.data(), Buffer.size());
+    }
+
+    // Use co_await Context.AsyncWrite(Fd, Buffer) to write to the file or socket
+    IoAwaiter AsyncWrite(int Fd, std::span<const std::byte> Buffer)
+    {
+        return IoAwaiter(*this, EIoOp::Write, Fd, const_cast<std::byte*>(Buffer.data()), Buffer.size());
+    }
+
+    // Use co_await Context.AsyncAccept(Fd) to accept the connection on the listening socket
+    IoAwaiter AsyncAccept(int Fd)
+    {
+        return IoAwaiter(*this, EIoOp::Accept, Fd, nullptr, 0);
+    }
+
+    // Run the loop until there are no pending operations. Returns the -errno if waiting for them has failed,
+    // in which case the pending coroutines stay suspended.
+    int Run()
+    {
+        while (NumPending > 0)
+        {
+            const int Ret = Backend == EIoBackend::IoUring ? RunOnceIoUring() : RunOnceEpoll();
+            if (Ret < 0 && Ret != -EINTR)
+            {
+                return Ret;
+            }
+        }
+        return 0;
+    }
+
+private:
+
+    // Maximum amount of completions handled in one loop iteration
+    static constexpr int MaxBatch = 64;
+
+    // Prepare the submission for the awaiter. It will be submitted to the kernel in the next loop iteration.
+    // Returns the -errno if there is no room for it.
+    int Submit(IoAwaiter* Awaiter)
+    {
+#if CORO_IO_URING
+        io_uring_sqe* Sqe = io_uring_get_sqe(&Ring);
+        if (Sqe == nullptr)
+        {
+            // The submission queue is full, so flush it to make room
+            const int Ret = io_uring_submit(&Ring);
+            if (Ret < 0)
+            {
+                return Ret;
+            }
+            Sqe = io_uring_get_sqe(&Ring);
+            if (Sqe == nullptr)
+            {
+                return -EBUSY;
+            }
+        }
+
+        switch (Awaiter->Op)
+        {
+            case EIoOp::Read: io_uring_prep_read(Sqe, Awaiter->Fd, Awaiter->Buffer, static_cast<unsigned>(Awaiter->Size), static_cast<__u64>(-1)); break;
+            case EIoOp::Write: io_uring_prep_write(Sqe, Awaiter->Fd, Awaiter->Buffer, static_cast<unsigned>(Awaiter->Size), static_cast<__u64>(-1)); break;
+            case EIoOp::Accept: io_uring_prep_accept(Sqe, Awaiter->Fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC); break;
+        }
+        io_uring_sqe_set_data(Sqe, Awaiter);
+        NumPending++;
+        return 0;
+#else
+        (void)Awaiter;
+        return -ENOSYS;
+#endif
+    }
+
+    // Submit every queued operation with one system call, wait for at least one completion and resume the completed coroutines
+    int RunOnceIoUring()
+    {
+#if CORO_IO_URING
+        const int Ret = io_uring_submit_and_wait(&Ring, 1);
+        if (Ret < 0)
+        {
+            return Ret;
+        }
+
+        // Copy the completions and release them first, because resumed coroutines will queue new submissions
+        io_uring_cqe* Cqes[MaxBatch];
+        const unsigned NumCqes = io_uring_peek_batch_cqe(&Ring, Cqes, MaxBatch);
+        IoAwaiter* Completed[MaxBatch];
+        for (unsigned i = 0; i < NumCqes; i++)
+        {
+            Completed[i] = static_cast<IoAwaiter*>(io_uring_cqe_get_data(Cqes[i]));
+            Completed[i]->Result = Cqes[i]->res;
+        }
+        io_uring_cq_advance(&Ring, NumCqes);
+
+        NumPending -= NumCqes;
+        for (unsigned i = 0; i < NumCqes; i++)
+        {
+            Completed[i]->Handle.resume();
+        }
+        return 0;
+#else
+        return -ENOSYS;
+#endif
+    }
+
+    // Wait for the file descriptor of the awaiter to become ready. Only one operation per file descriptor can wait at once.
+    // Returns the -errno if the file descriptor can't be watched.
+    int Arm(IoAwaiter* Awaiter)
+    {
+        epoll_event Event = {};
+        Event.events = (Awaiter->Op == EIoOp::Write ? EPOLLOUT : EPOLLIN) | EPOLLONESHOT;
+        Event.data.ptr = Awaiter;
+        if (::epoll_ctl(EpollFd, EPOLL_CTL_MOD, Awaiter->Fd, &Event) < 0)
+        {
+            if (errno != ENOENT || ::epoll_ctl(EpollFd, EPOLL_CTL_ADD, Awaiter->Fd, &Event) < 0)
+            {
+                return -errno;
+            }
+        }
+        NumPending++;
+        return 0;
+    }
+
+    // Wait for ready file descriptors, perform their operations and resume the coroutines
+    int RunOnceEpoll()
+    {
+        epoll_event Events[MaxBatch];
+        const int NumEvents = ::epoll_wait(EpollFd, Events, MaxBatch, -1);
+        if (NumEvents < 0)
+        {
+            return -errno;
+        }
+        for (int i = 0; i < NumEvents; i++)
+        {
+            IoAwaiter* Awaiter = static_cast<IoAwaiter*>(Events[i].data.ptr);
+            Awaiter->Result = Awaiter->Perform();
+            NumPending--;
+            if (Awaiter->Result == -EAGAIN || Awaiter->Result == -EWOULDBLOCK)
+            {
+                // Spurious wake up, wait again
+                const int Ret = Arm(Awaiter);
+                if (Ret == 0)
+                {
+                    continue;
+                }
+                Awaiter->Result = Ret;
+            }
+            Awaiter->Handle.resume();
+        }
+        return 0;
+    }
+
+    EIoBackend Backend = EIoBackend::None;
+    int Error = 0;
+
+#if CORO_IO_URING
+    io_uring Ring;
+#endif
+    int EpollFd = -1;
+
+    // Amount of operations waiting for completion
+    int NumPending = 0;
+};
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroPromise;
+};
+
+// Definition of the coroutine Promise
+struct CoroPromise
+{
+    // Called in order to construct the coroutine Handle
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+
+    // Do not suspend when the coroutine starts
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    // Do not suspend when the coroutine ends
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs
+    void unhandled_exception() {}
+};
+
+// Server coroutine which accepts a single connection and prints everything it receives
+CoroHandle ServerCoroutine(CoroIoContext& Context, int ListenFd)
+{
+    const int ClientFd = co_await Context.AsyncAccept(ListenFd);
+    if (ClientFd < 0)
+    {
+        std::cout << "Accept failed: " << std::strerror(-ClientFd) << "\n";
+        co_return;
+    }
+    std::cout << "Connection accepted\n";
+
+    std::byte Buffer[256];
+    for (;;)
+    {
+        const int Read = co_await Context.AsyncRead(ClientFd, Buffer);
+        if (Read <= 0)
+        {
+            break;
+        }
+        std::cout << "Received: " << std::string_view(reinterpret_cast<const char*>(Buffer), Read) << "\n";
+    }
+
+    std::cout << "Connection closed\n";
+    ::close(ClientFd);
+}
+
+// Client coroutine which sends a message and closes the connection
+CoroHandle ClientCoroutine(CoroIoContext& Context, int Fd)
+{
+    constexpr std::string_view Message = "Hello from the coroutine";
+    const int Written = co_await Context.AsyncWrite(Fd, std::as_bytes(std::span(Message)));
+    std::cout << "Sent " << Written << " bytes\n";
+    ::close(Fd);
+}
+
+// Main program
+int main()
+{
+    CoroIoContext Context;
+    if (Context.GetError() < 0)
+    {
+        std::cout << "Can't create the I/O context: " << std::strerror(-Context.GetError()) << "\n";
+        return 1;
+    }
+
+    // Listen on a random port of the loopback interface
+    const int ListenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    sockaddr_in Address = {};
+    Address.sin_family = AF_INET;
+    Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    Address.sin_port = 0;
+    ::bind(ListenFd, reinterpret_cast<sockaddr*>(&Address), sizeof(Address));
+    ::listen(ListenFd, 16);
+    socklen_t AddressLength = sizeof(Address);
+    ::getsockname(ListenFd, reinterpret_cast<sockaddr*>(&Address), &AddressLength);
+
+    // The server suspends until somebody connects
+    ServerCoroutine(Context, ListenFd);
+
+    // Connecting to the loopback interface finishes right away, because the kernel completes the handshake in the backlog
+    const int ClientFd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    ::connect(ClientFd, reinterpret_cast<sockaddr*>(&Address), sizeof(Address));
+    ::fcntl(ClientFd, F_SETFL, ::fcntl(ClientFd, F_GETFL) | O_NONBLOCK);
+    ClientCoroutine(Context, ClientFd);
+
+    // Resume coroutines as their operations complete, until there is nothing left to wait for
+    const int Ret = Context.Run();
+    if (Ret < 0)
+    {
+        std::cout << "Waiting for I/O failed: " << std::strerror(-Ret) << "\n";
+    }
+
+    ::close(ListenFd);
+    return 0;
+}
+
+/**
+ The program should output (with io_uring the first two lines can be swapped):
+
+ Sent 24 bytes
+ Connection accepted
+ Received: Hello from the coroutine
+ Connection closed
+*/
@@ -0,0 +1,559 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of awaiting many c++ coroutine tasks at once.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Forward declaration of the Task so it can be used inside the Promise
+template<typename T>
+class Task;
+
+// Interface of the combinator which waits for the Task instead of a single awaiting coroutine
+struct CoroTaskJoin
+{
+    // Called when the joined Task finishes. Returns the coroutine which should be resumed next.
+    virtual std::coroutine_handle<> OnTaskDone(std::size_t Index) noexcept = 0;
+
+protected:
+
+    // Combinators are never deleted through this interface
+    ~CoroTaskJoin() = default;
+};
+
+// Common part of the Promise of every Task
+struct TaskPromiseBase
+{
+    // Awaiter used when the Task finishes. It transfers the execution directly to the awaiting coroutine
+    // or lets the combinator decide what to resume.
+    struct FinalAwaiter
+    {
+        bool await_ready() noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> Handle) noexcept
+        {
+            TaskPromiseBase& Base = Handle.promise();
+            if (Base.Join)
+            {
+                return Base.Join->OnTaskDone(Base.JoinIndex);
+            }
+            return Base.Continuation;
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    // Coroutine which awaits this Task
+    std::coroutine_handle<> Continuation = std::noop_coroutine();
+
+    // Combinator which waits for this Task and the index of this Task inside it
+    CoroTaskJoin* Join = nullptr;
+    std::size_t JoinIndex = 0;
+
+    // Exception thrown inside the Task
+    std::exception_ptr Exception;
+
+    // Suspend the Task at the beginning, so it starts only when awaited
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    // Transfer the execution to the awaiting coroutine at the end
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    // Called when exception occurs. Remember it, so it can be rethrown later.
+    void unhandled_exception() { Exception = std::current_exception(); }
+};
+
+// Definition of the Task Promise which stores the result of a generic type
+template<typename T>
+struct TaskPromise : TaskPromiseBase
+{
+    std::optional<T> Value;
+
+    Task<T> get_return_object();
+
+    template<std::convertible_to<T> From>
+    void return_value(From&& from) { Value.emplace(std::forward<From>(from)); }
+
+    T GetResult()
+    {
+        if (Exception)
+        {
+            std::rethrow_exception(Exception);
+        }
+        return std::move(*Value);
+    }
+};
+
+// Definition of the Task Promise for Tasks which don't return anything
+template<>
+struct TaskPromise<void> : TaskPromiseBase
+{
+    Task<void> get_return_object();
+
+    void return_void() {}
+
+    void GetResult()
+    {
+        if (Exception)
+        {
+            std::rethrow_exception(Exception);
+        }
+    }
+};
+
+// Definition of the lazy Task, the same as in the 07_CoroLazyTasks.cpp sample, but it can be started by a combinator
+template<typename T = void>
+class Task
+{
+public:
+
+    using promise_type = TaskPromise<T>;
+    using CoroHandle = std::coroutine_handle<promise_type>;
+
+    explicit Task(CoroHandle InHandle) : Handle(InHandle) {}
+    Task(Task&& Other) noexcept : Handle(std::exchange(Other.Handle, {})) {}
+    Task& operator=(Task&& Other) noexcept
+    {
+        if (this != &Other)
+        {
+            if (Handle)
+            {
+                Handle.destroy();
+            }
+            Handle = std::exchange(Other.Handle, {});
+        }
+        return *this;
+    }
+    ~Task()
+    {
+        if (Handle)
+        {
+            Handle.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return !Handle || Handle.done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> Awaiting) noexcept
+    {
+        Handle.promise().Continuation = Awaiting;
+        return Handle;
+    }
+
+    T await_resume() { return Handle.promise().GetResult(); }
+
+    void Start() { Handle.resume(); }
+    bool IsDone() const { return Handle.done(); }
+    T GetResult() { return Handle.promise().GetResult(); }
+
+    // Start the Task for the combinator. When the Task finishes it notifies the combinator instead of resuming the continuation.
+    void StartJoined(CoroTaskJoin& Join, std::size_t Index)
+    {
+        Handle.promise().Join = &Join;
+        Handle.promise().JoinIndex = Index;
+        Handle.resume();
+    }
+
+private:
+
+    CoroHandle Handle;
+};
+
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object() { return Task<T>(Task<T>::CoroHandle::from_promise(*this)); }
+
+inline Task<void> TaskPromise<void>::get_return_object() { return Task<void>(Task<void>::CoroHandle::from_promise(*this)); }
+
+// Tasks which don't return anything give std::monostate inside the results of combinators
+template<typename T>
+using TaskResult = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+// Get the result of the finished Task, replacing void with std::monostate
+template<typename T>
+TaskResult<T> GetTaskResult(Task<T>& InTask)
+{
+    if constexpr (std::is_void_v<T>)
+    {
+        InTask.GetResult();
+        return {};
+    }
+    else
+    {
+        return InTask.GetResult();
+    }
+}
+
+// Awaiter which starts all given Tasks at once and resumes the awaiting coroutine when the last of them finishes.
+// The Tasks are stored inline, inside the awaiter, which lives in the awaiting coroutine frame.
+template<typename... Ts>
+class WhenAllAwaiter : private CoroTaskJoin
+{
+public:
+
+    explicit WhenAllAwaiter(Task<Ts>&&... InTasks) : Tasks(std::move(InTasks)...) {}
+
+    // Nothing to wait for if there are no Tasks
+    bool await_ready() const noexcept { return sizeof...(Ts) == 0; }
+
+    // Start every Task. The counter has one extra count held by this function, so the awaiting coroutine can't be resumed
+    // before every Task has been started. If all Tasks finish synchronously the coroutine doesn't suspend at all.
+    bool await_suspend(std::coroutine_handle<> Awaiting) noexcept
+    {
+        Continuation = Awaiting;
+        Counter.store(sizeof...(Ts) + 1, std::memory_order_relaxed);
+        std::size_t Index = 0;
+        std::apply([this, &Index](auto&... InTasks) { (InTasks.StartJoined(*this, Index++), ...); }, Tasks);
+        return Counter.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+
+    // Collect the results from every Task. Rethrows the exception from the first failed Task.
+    std::tuple<TaskResult<Ts>...> await_resume()
+    {
+        return std::apply([](auto&... InTasks) { return std::tuple<TaskResult<Ts>...>(GetTaskResult(InTasks)...); }, Tasks);
+    }
+
+private:
+
+    // The last finished Task resumes the awaiting coroutine
+    std::coroutine_handle<> OnTaskDone(std::size_t) noexcept override
+    {
+        if (Counter.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            return Continuation;
+        }
+        return std::noop_coroutine();
+    }
+
+    std::tuple<Task<Ts>...> Tasks;
+    std::coroutine_handle<> Continuation;
+    std::atomic<std::size_t> Counter = 0;
+};
+
+// Use co_await WhenAll(TaskA(), TaskB(), ...) to run Tasks at once and get all of their results as a tuple
+template<typename... Ts>
+WhenAllAwaiter<Ts...> WhenAll(Task<Ts>... Tasks)
+{
+    return WhenAllAwaiter<Ts...>(std::move(Tasks)...);
+}
+
+// The same as above, but for any amount of Tasks of the same type known only at runtime
+template<typename T>
+class WhenAllRangeAwaiter : private CoroTaskJoin
+{
+public:
+
+    explicit WhenAllRangeAwaiter(std::vector<Task<T>> InTasks) : Tasks(std::move(InTasks)) {}
+
+    bool await_ready() const noexcept { return Tasks.empty(); }
+
+    bool await_suspend(std::coroutine_handle<> Awaiting) noexcept
+    {
+        Continuation = Awaiting;
+        Counter.store(Tasks.size() + 1, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < Tasks.size(); i++)
+        {
+            Tasks[i].StartJoined(*this, i);
+        }
+        return Counter.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+
+    // Returns the vector of results, or nothing for the Tasks which don't return anything
+    auto await_resume()
+    {
+        if constexpr (std::is_void_v<T>)
+        {
+            for (Task<T>& InTask : Tasks)
+            {
+                InTask.GetResult();
+            }
+        }
+        else
+        {
+            std::vector<T> Results;
+            Results.reserve(Tasks.size());
+            for (Task<T>& InTask : Tasks)
+            {
+                Results.push_back(InTask.GetResult());
+            }
+            return Results;
+        }
+    }
+
+private:
+
+    std::coroutine_handle<> OnTaskDone(std::size_t) noexcept override
+    {
+        if (Counter.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            return Continuation;
+        }
+        return std::noop_coroutine();
+    }
+
+    std::vector<Task<T>> Tasks;
+    std::coroutine_handle<> Continuation;
+    std::atomic<std::size_t> Counter = 0;
+};
+
+// Use co_await WhenAll(std::move(VectorOfTasks)) to run Tasks at once and get all of their results as a vector
+template<typename T>
+WhenAllRangeAwaiter<T> WhenAll(std::vector<Task<T>> Tasks)
+{
+    return WhenAllRangeAwaiter<T>(std::move(Tasks));
+}
+
+// Result of WhenAny: index of the first finished Task and it's value
+template<typename T>
+struct WhenAnyResult
+{
+    std::size_t Index;
+    TaskResult<T> Value;
+};
+
+// Awaiter which starts all given Tasks at once and resumes the awaiting coroutine when the first of them finishes.
+// The other Tasks keep running after the awaiting coroutine has been resumed, so they are stored in the state
+// allocated once for the whole combinator, which is deleted by the last finished Task.
+template<typename T, std::size_t N>
+class WhenAnyAwaiter
+{
+public:
+
+    explicit WhenAnyAwaiter(std::array<Task<T>, N>&& InTasks) : State(new FState(std::move(InTasks))) {}
+
+    // The state is owned by the awaiter only until the Tasks are started
+    WhenAnyAwaiter(const WhenAnyAwaiter&) = delete;
+    WhenAnyAwaiter& operator=(const WhenAnyAwaiter&) = delete;
+    ~WhenAnyAwaiter()
+    {
+        if (bStarted == false)
+        {
+            delete State;
+        }
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    // Start every Task. If the first Task finishes before all of them have been started the coroutine doesn't suspend.
+    bool await_suspend(std::coroutine_handle<> Awaiting) noexcept
+    {
+        FState* LocalState = State;
+        bStarted = true;
+        LocalState->Awaiter = this;
+        LocalState->Continuation = Awaiting;
+        for (std::size_t i = 0; i < N; i++)
+        {
+            LocalState->Tasks[i].StartJoined(*LocalState, i);
+        }
+
+        // The awaiter can't be used after the gate is passed, because the coroutine might be already resumed
+        const bool bWinnerDone = LocalState->bGate.exchange(true, std::memory_order_acq_rel);
+        LocalState->Release();
+        return bWinnerDone == false;
+    }
+
+    // Returns the index and the result of the first finished Task
+    WhenAnyResult<T> await_resume()
+    {
+        if (Exception)
+        {
+            std::rethrow_exception(Exception);
+        }
+        return { Index, std::move(*Value) };
+    }
+
+private:
+
+    // State shared by all Tasks of the combinator
+    struct FState final : CoroTaskJoin
+    {
+        explicit FState(std::array<Task<T>, N>&& InTasks) : Tasks(std::move(InTasks)) {}
+
+        // The first finished Task moves it's result to the awaiter. The last finished Task deletes the state.
+        std::coroutine_handle<> OnTaskDone(std::size_t TaskIndex) noexcept override
+        {
+            std::coroutine_handle<> Next = std::noop_coroutine();
+            std::size_t NoWinner = N;
+            if (Winner.compare_exchange_strong(NoWinner, TaskIndex, std::memory_order_acq_rel))
+            {
+                Awaiter->Index = TaskIndex;
+                try
+                {
+                    Awaiter->Value.emplace(GetTaskResult(Tasks[TaskIndex]));
+                }
+                catch (...)
+                {
+                    Awaiter->Exception = std::current_exception();
+                }
+
+                // Resume the awaiting coroutine only if all Tasks have already been started
+                if (bGate.exchange(true, std::memory_order_acq_rel))
+                {
+                    Next = Continuation;
+                }
+            }
+            Release();
+            return Next;
+        }
+
+        // Every Task and the starting function hold one reference to the state
+        void Release() noexcept
+        {
+            if (References.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                delete this;
+            }
+        }
+
+        std::array<Task<T>, N> Tasks;
+        WhenAnyAwaiter* Awaiter = nullptr;
+        std::coroutine_handle<> Continuation;
+        std::atomic<std::size_t> Winner = N;
+        std::atomic<std::size_t> References = N + 1;
+        std::atomic<bool> bGate = false;
+    };
+
+    FState* State;
+    bool bStarted = false;
+    std::size_t Index = 0;
+    std::optional<TaskResult<T>> Value;
+    std::exception_ptr Exception;
+};
+
+// Use co_await WhenAny(TaskA(), TaskB(), ...) to run Tasks of the same type at once and get the result of the first finished one
+template<typename T, typename... Ts>
+    requires (std::same_as<Task<T>, Ts> && ...)
+WhenAnyAwaiter<T, sizeof...(Ts) + 1> WhenAny(Task<T> First, Ts... Rest)
+{
+    return WhenAnyAwaiter<T, sizeof...(Ts) + 1>(std::array<Task<T>, sizeof...(Ts) + 1>{ std::move(First), std::move(Rest)... });
+}
+
+// Simple clock advanced manually, used to simulate operations which take time
+class ManualClock
+{
+public:
+
+    // Awaiter suspending the coroutine for the given amount of ticks
+    struct WaitTicksTask
+    {
+        ManualClock& Clock;
+        uint64_t Ticks;
+
+        bool await_ready() const noexcept { return Ticks == 0; }
+        void await_suspend(std::coroutine_handle<> Handle) { Clock.Timers.push_back({ Clock.Now + Ticks, Handle }); }
+        void await_resume() const noexcept {}
+    };
+
+    WaitTicksTask WaitTicks(uint64_t Ticks) { return { *this, Ticks }; }
+
+    // Advance the clock by one tick and resume every expired coroutine
+    void Tick()
+    {
+        Now++;
+        std::vector<FTimer> Expired;
+        std::erase_if(Timers, [this, &Expired](const FTimer& Timer)
+        {
+            if (Timer.Deadline <= Now)
+            {
+                Expired.push_back(Timer);
+                return true;
+            }
+            return false;
+        });
+        for (const FTimer& Timer : Expired)
+        {
+            Timer.Handle.resume();
+        }
+    }
+
+    uint64_t GetNow() const { return Now; }
+    bool HasTimers() const { return Timers.empty() == false; }
+
+private:
+
+    struct FTimer
+    {
+        uint64_t Deadline;
+        std::coroutine_handle<> Handle;
+    };
+
+    uint64_t Now = 0;
+    std::vector<FTimer> Timers;
+};
+
+// Task simulating a request which takes the given amount of ticks
+Task<int> RequestTask(ManualClock& Clock, int Id, uint64_t Ticks)
+{
+    co_await Clock.WaitTicks(Ticks);
+    co_return Id * 10;
+}
+
+// Task which doesn't return anything
+Task<> LogTask(ManualClock& Clock, uint64_t Ticks)
+{
+    co_await Clock.WaitTicks(Ticks);
+}
+
+// Task which runs requests at once using combinators
+Task<> MainTask(ManualClock& Clock)
+{
+    // All requests run at the same time, so it takes only as long as the slowest one
+    const uint64_t AllStart = Clock.GetNow();
+    auto [A, B, Log] = co_await WhenAll(RequestTask(Clock, 1, 3), RequestTask(Clock, 2, 5), LogTask(Clock, 2));
+    std::cout << "WhenAll: " << A << " " << B << " after " << Clock.GetNow() - AllStart << " ticks\n";
+
+    // Any amount of Tasks known only at runtime
+    std::vector<Task<int>> Requests;
+    for (int i = 1; i <= 4; i++)
+    {
+        Requests.push_back(RequestTask(Clock, i, i));
+    }
+    const std::vector<int> Results = co_await WhenAll(std::move(Requests));
+    std::cout << "WhenAll vector: " << Results.size() << " results, last " << Results.back() << "\n";
+
+    // The first finished request wins
+    const uint64_t AnyStart = Clock.GetNow();
+    const WhenAnyResult<int> First = co_await WhenAny(RequestTask(Clock, 1, 4), RequestTask(Clock, 2, 1), RequestTask(Clock, 3, 6));
+    std::cout << "WhenAny: index " << First.Index << " value " << First.Value << " after " << Clock.GetNow() - AnyStart << " ticks\n";
+}
+
+// Main program
+int main()
+{
+    ManualClock Clock;
+
+    Task<> task = MainTask(Clock);
+    task.Start();
+
+    // Tick the clock until every Task, including the ones which lost the WhenAny, has finished
+    while (Clock.HasTimers())
+    {
+        Clock.Tick();
+    }
+
+    std::cout << "Main Task Done: " << task.IsDone() << "\n";
+
+    return 0;
+}
+
+/**
+ The program should output:
+
+ WhenAll: 10 20 after 5 ticks
+ WhenAll vector: 4 results, last 40
+ WhenAny: index 1 value 20 after 1 ticks
+ Main Task Done: 1
+*/
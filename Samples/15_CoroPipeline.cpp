@@ -0,0 +1,462 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutine generator combined with pipeline stages which don't create coroutines.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <coroutine>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+// Amount of created Generator frames and Generator resumes, so the cost of the pipelines can be compared
+struct GeneratorStats
+{
+    static inline std::size_t NumFrames = 0;
+    static inline std::size_t NumResumes = 0;
+};
+
+// Definition of the coroutine Generator, the same as in the 03_CoroGenerators.cpp sample
+template<typename T>
+struct CoroGenerator
+{
+    // Forward declaration of the Promise so it can be used for a Handle definition
+    struct CoroPromise;
+
+    // Tell the Generator to use our Promise
+    using promise_type = CoroPromise;
+
+    // Convinient alias for the coroutine Handle type which uses declared Promise
+    using CoroHandle = std::coroutine_handle<CoroPromise>;
+
+    // Definition of the Generator Promise
+    struct CoroPromise
+    {
+        // Pointer to the lastly yielded value
+        const T* Value = nullptr;
+
+        // Count every created coroutine frame
+        static void* operator new(std::size_t Size)
+        {
+            GeneratorStats::NumFrames++;
+            return ::operator new(Size);
+        }
+
+        static void operator delete(void* Ptr, std::size_t Size)
+        {
+            ::operator delete(Ptr, Size);
+        }
+
+        // Called in order to construct the Generator
+        CoroGenerator get_return_object() { return CoroGenerator(CoroHandle::from_promise(*this)); }
+
+        // Suspend the Generator at the beginning
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // Suspend the Generator at the end
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        // Called when co_return is used
+        void return_void() {}
+
+        // Called when exception occurs
+        void unhandled_exception() {}
+
+        // Called when co_yield is used. The yielded value stays valid until the Generator is resumed.
+        std::suspend_always yield_value(const T& from)
+        {
+            Value = std::addressof(from);
+            return {};
+        }
+    };
+
+    // Iterator which resumes the Generator when incremented and gives access to the lastly yielded value
+    class Iterator
+    {
+    public:
+
+        // Types required by the std::input_iterator concept
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        // Iterators must be default constructible in order to be used with std::ranges
+        Iterator() = default;
+
+        // Constructor - remember the Handle of the iterated Generator
+        explicit Iterator(CoroHandle InHandle) : Handle(InHandle) {}
+
+        // Get the lastly yielded value by reference, directly from the coroutine frame
+        const T& operator*() const { return *Handle.promise().Value; }
+
+        // Resume the Generator, so it yields the next value
+        Iterator& operator++()
+        {
+            GeneratorStats::NumResumes++;
+            Handle.resume();
+            return *this;
+        }
+
+        // Post increment doesn't have to return anything for input iterators
+        void operator++(int) { ++*this; }
+
+        // Iterator reached the end when the Generator has finished
+        bool operator==(std::default_sentinel_t) const { return Handle.done(); }
+
+    private:
+
+        // Handle of the iterated Generator
+        CoroHandle Handle;
+    };
+
+    // Start the Generator and get the Iterator to the first yielded value
+    Iterator begin()
+    {
+        GeneratorStats::NumResumes++;
+        Handle.resume();
+        return Iterator(Handle);
+    }
+
+    // The end of the Generator is represented by the default sentinel
+    std::default_sentinel_t end() { return {}; }
+
+    // Constructor - save the coroutine Handle given during the get_return_object call in the Promise
+    explicit CoroGenerator(CoroHandle InHandle) : Handle(InHandle) {}
+
+    // Generator owns the coroutine Handle, so it can be only moved
+    CoroGenerator(const CoroGenerator&) = delete;
+    CoroGenerator& operator=(const CoroGenerator&) = delete;
+    CoroGenerator(CoroGenerator&& Other) noexcept : Handle(std::exchange(Other.Handle, {})) {}
+    CoroGenerator& operator=(CoroGenerator&& Other) noexcept
+    {
+        if (this != &Other)
+        {
+            if (Handle)
+            {
+                Handle.destroy();
+            }
+            Handle = std::exchange(Other.Handle, {});
+        }
+        return *this;
+    }
+
+    // Destructor - explicitly destroy the coroutine Handle, because of the final_suspend set to suspend_always
+    ~CoroGenerator()
+    {
+        if (Handle)
+        {
+            Handle.destroy();
+        }
+    }
+
+private:
+
+    // Stores the coroutine Handle used within this Generator
+    CoroHandle Handle;
+};
+
+// Pipeline stage which transforms every value. It is the plain object holding the source and the function,
+// so it doesn't create any coroutine frame and it doesn't resume anything on it's own.
+template<typename Source, typename F>
+class MapView
+{
+public:
+
+    MapView(Source&& InBase, F InFunc) : Base(std::move(InBase)), Func(std::move(InFunc)) {}
+
+    // Iterator which calls the function on the value of the source Iterator when dereferenced
+    class Iterator
+    {
+    public:
+
+        using BaseIterator = std::ranges::iterator_t<Source>;
+        using value_type = std::remove_cvref_t<std::invoke_result_t<F&, std::iter_reference_t<BaseIterator>>>;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+        Iterator(MapView* InView, BaseIterator InIt) : View(InView), It(std::move(InIt)) {}
+
+        value_type operator*() const { return std::invoke(View->Func, *It); }
+
+        // Incrementing is passed directly to the source, so the whole pipeline moves by one resume of the Generator
+        Iterator& operator++()
+        {
+            ++It;
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t End) const { return It == End; }
+
+    private:
+
+        MapView* View = nullptr;
+        BaseIterator It;
+    };
+
+    Iterator begin() { return Iterator(this, std::ranges::begin(Base)); }
+    std::default_sentinel_t end() { return {}; }
+
+private:
+
+    Source Base;
+    F Func;
+};
+
+// Pipeline stage which skips values not matching the predicate
+template<typename Source, typename P>
+class FilterView
+{
+public:
+
+    FilterView(Source&& InBase, P InPred) : Base(std::move(InBase)), Pred(std::move(InPred)) {}
+
+    // Iterator which is always placed on the value matching the predicate, or on the end of the source
+    class Iterator
+    {
+    public:
+
+        using BaseIterator = std::ranges::iterator_t<Source>;
+        using value_type = std::iter_value_t<BaseIterator>;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+        Iterator(FilterView* InView, BaseIterator InIt) : View(InView), It(std::move(InIt)) { SkipRejected(); }
+
+        decltype(auto) operator*() const { return *It; }
+
+        Iterator& operator++()
+        {
+            ++It;
+            SkipRejected();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t End) const { return It == End; }
+
+    private:
+
+        // Rejected values are skipped inside this loop, without going back to the consumer
+        void SkipRejected()
+        {
+            while (It != std::default_sentinel && std::invoke(View->Pred, *It) == false)
+            {
+                ++It;
+            }
+        }
+
+        FilterView* View = nullptr;
+        BaseIterator It;
+    };
+
+    Iterator begin() { return Iterator(this, std::ranges::begin(Base)); }
+    std::default_sentinel_t end() { return {}; }
+
+private:
+
+    Source Base;
+    P Pred;
+};
+
+// Pipeline stage which ends after the given amount of values
+template<typename Source>
+class TakeView
+{
+public:
+
+    TakeView(Source&& InBase, std::size_t InCount) : Base(std::move(InBase)), Count(InCount) {}
+
+    // Iterator which counts down the remaining values
+    class Iterator
+    {
+    public:
+
+        using BaseIterator = std::ranges::iterator_t<Source>;
+        using value_type = std::iter_value_t<BaseIterator>;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+        Iterator(BaseIterator InIt, std::size_t InRemaining) : It(std::move(InIt)), Remaining(InRemaining) {}
+
+        decltype(auto) operator*() const { return *It; }
+
+        // The source is not advanced after the last taken value, so the Generator is not resumed for nothing
+        Iterator& operator++()
+        {
+            if (--Remaining > 0)
+            {
+                ++It;
+            }
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        bool operator==(std::default_sentinel_t End) const { return Remaining == 0 || It == End; }
+
+    private:
+
+        BaseIterator It;
+        std::size_t Remaining = 0;
+    };
+
+    // Taking nothing doesn't even start the source
+    Iterator begin() { return Count > 0 ? Iterator(std::ranges::begin(Base), Count) : Iterator(); }
+    std::default_sentinel_t end() { return {}; }
+
+private:
+
+    Source Base;
+    std::size_t Count;
+};
+
+// Stage descriptions returned by Map, Filter and Take. They only hold the arguments until they are
+// combined with the source using the operator |.
+template<typename F>
+struct MapStage
+{
+    F Func;
+};
+
+template<typename P>
+struct FilterStage
+{
+    P Pred;
+};
+
+struct TakeStage
+{
+    std::size_t Count;
+};
+
+template<typename F>
+MapStage<F> Map(F Func) { return { std::move(Func) }; }
+
+template<typename P>
+FilterStage<P> Filter(P Pred) { return { std::move(Pred) }; }
+
+inline TakeStage Take(std::size_t Count) { return { Count }; }
+
+// Combine the source with the stage. The source is moved inside the stage, so every pipeline is the single object
+// nesting all of it's stages, with the Generator inside the innermost one.
+template<typename Source, typename F>
+    requires (!std::is_lvalue_reference_v<Source>)
+MapView<Source, F> operator|(Source&& Base, MapStage<F> Stage)
+{
+    return MapView<Source, F>(std::move(Base), std::move(Stage.Func));
+}
+
+template<typename Source, typename P>
+    requires (!std::is_lvalue_reference_v<Source>)
+FilterView<Source, P> operator|(Source&& Base, FilterStage<P> Stage)
+{
+    return FilterView<Source, P>(std::move(Base), std::move(Stage.Pred));
+}
+
+template<typename Source>
+    requires (!std::is_lvalue_reference_v<Source>)
+TakeView<Source> operator|(Source&& Base, TakeStage Stage)
+{
+    return TakeView<Source>(std::move(Base), Stage.Count);
+}
+
+// Every pipeline is still a range, so it can be used with range based for loops and algorithms
+static_assert(std::ranges::input_range<MapView<CoroGenerator<int>, int(*)(int)>>);
+static_assert(std::ranges::input_range<TakeView<FilterView<CoroGenerator<int>, bool(*)(int)>>>);
+
+// Generator which yields numbers from 0 to Amount - 1
+CoroGenerator<int> CountGenerator(const int Amount)
+{
+    for (int i = 0; i < Amount; i++)
+    {
+        co_yield i;
+    }
+}
+
+// The same stages written as coroutines wrapping another Generator. Every stage creates it's own frame
+// and every value passing through it costs one more resume.
+template<typename F>
+CoroGenerator<int> MapCoroutine(CoroGenerator<int> Source, F Func)
+{
+    for (const int Value : Source)
+    {
+        co_yield Func(Value);
+    }
+}
+
+template<typename P>
+CoroGenerator<int> FilterCoroutine(CoroGenerator<int> Source, P Pred)
+{
+    for (const int Value : Source)
+    {
+        if (Pred(Value))
+        {
+            co_yield Value;
+        }
+    }
+}
+
+CoroGenerator<int> TakeCoroutine(CoroGenerator<int> Source, std::size_t Count)
+{
+    if (Count == 0)
+    {
+        co_return;
+    }
+    for (const int Value : Source)
+    {
+        co_yield Value;
+        if (--Count == 0)
+        {
+            co_return;
+        }
+    }
+}
+
+// Build the pipeline, print it's values and the amount of frames and resumes needed to produce them
+template<typename MakeFunc>
+void PrintPipeline(const char* Name, MakeFunc&& MakePipeline)
+{
+    GeneratorStats::NumFrames = 0;
+    GeneratorStats::NumResumes = 0;
+
+    std::cout << Name << ":";
+    for (const int Value : MakePipeline())
+    {
+        std::cout << " " << Value;
+    }
+    std::cout << " (frames: " << GeneratorStats::NumFrames << ", resumes: " << GeneratorStats::NumResumes << ")\n";
+}
+
+// Main program
+int main()
+{
+    const auto IsOdd = [](int Value) { return Value % 2 == 1; };
+    const auto Square = [](int Value) { return Value * Value; };
+    const auto AddOne = [](int Value) { return Value + 1; };
+    const auto NotDivisibleBy5 = [](int Value) { return Value % 5 != 0; };
+
+    // Five stages fused into the consumer loop. Only the Generator is a coroutine, so one resume produces one value
+    // for the whole pipeline, and the Generator is not resumed anymore after the 3rd value has been taken.
+    PrintPipeline("Fused", [&]()
+    {
+        return CountGenerator(100) | Filter(IsOdd) | Map(Square) | Map(AddOne) | Filter(NotDivisibleBy5) | Take(3);
+    });
+
+    // The same pipeline built from nested coroutines. Every stage is a frame and every value is resumed through every stage below it.
+    PrintPipeline("Nested", [&]()
+    {
+        return TakeCoroutine(FilterCoroutine(MapCoroutine(MapCoroutine(FilterCoroutine(CountGenerator(100), IsOdd), Square), AddOne), NotDivisibleBy5), 3);
+    });
+
+    return 0;
+}
+
+/**
+ The program should output:
+
+ Fused: 2 26 82 (frames: 1, resumes: 10)
+ Nested: 2 26 82 (frames: 6, resumes: 32)
+*/
@@ -0,0 +1,295 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of coroutines in Unreal Engine 5 which can allocate their frames from an arena owned by a gameplay system.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <coroutine>
+#include <new>
+#include "Containers/Ticker.h"
+#include "Kismet/GameplayStatics.h"
+
+// Arena giving memory by bumping a pointer inside big blocks. Frames are never freed one by one, the whole arena
+// is released at once when all of it's coroutines have finished. It is meant to be used only on the game thread.
+class CoroArena
+{
+public:
+
+    // Size of a single block taken from the engine allocator. Frames bigger than that get their own block.
+    static constexpr SIZE_T BlockSize = 64 * 1024;
+
+    // Every frame is aligned like memory given by the global operator new
+    static constexpr SIZE_T Alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+    CoroArena() = default;
+    CoroArena(const CoroArena&) = delete;
+    CoroArena& operator=(const CoroArena&) = delete;
+
+    // Give all blocks back to the engine allocator
+    ~CoroArena()
+    {
+        check(NumLiveFrames == 0);
+        FreeLargeBlocks();
+        for (uint8* Block : Blocks)
+        {
+            FMemory::Free(Block);
+        }
+    }
+
+    // Take the memory for a new frame
+    void* Allocate(SIZE_T Size)
+    {
+        check(IsInGameThread());
+
+        Size = Align(Size, Alignment);
+        NumLiveFrames++;
+
+        // Frames bigger than the block get their own allocation, which is freed together with the arena
+        if (Size > BlockSize)
+        {
+            return LargeBlocks.Add_GetRef(static_cast<uint8*>(FMemory::Malloc(Size, Alignment)));
+        }
+
+        if (CurrentBlock == INDEX_NONE || Offset + Size > BlockSize)
+        {
+            NextBlock();
+        }
+
+        void* Frame = Blocks[CurrentBlock] + Offset;
+        Offset += Size;
+        return Frame;
+    }
+
+    // Called when the frame is destroyed. The memory stays in the arena until it is released.
+    void Deallocate(void* Ptr)
+    {
+        check(IsInGameThread());
+        check(NumLiveFrames > 0);
+        NumLiveFrames--;
+    }
+
+    // Rewind the arena to the first block, so all of the memory can be reused. Blocks are kept, so the next
+    // burst of coroutines doesn't touch the engine allocator at all. Can be called only when all coroutines have finished.
+    void ReleaseAll()
+    {
+        check(NumLiveFrames == 0);
+        FreeLargeBlocks();
+        CurrentBlock = Blocks.Num() > 0 ? 0 : INDEX_NONE;
+        Offset = 0;
+    }
+
+    // Amount of frames allocated from the arena which are not destroyed yet
+    int32 GetNumLiveFrames() const { return NumLiveFrames; }
+
+private:
+
+    // Move to the next kept block or allocate a new one
+    void NextBlock()
+    {
+        CurrentBlock++;
+        if (CurrentBlock == Blocks.Num())
+        {
+            Blocks.Add(static_cast<uint8*>(FMemory::Malloc(BlockSize, Alignment)));
+        }
+        Offset = 0;
+    }
+
+    // Oversized frames are not reused between bursts
+    void FreeLargeBlocks()
+    {
+        for (uint8* Block : LargeBlocks)
+        {
+            FMemory::Free(Block);
+        }
+        LargeBlocks.Reset();
+    }
+
+    // Blocks taken from the engine allocator, reused by every burst
+    TArray<uint8*> Blocks;
+
+    // Allocations of the frames bigger than the block
+    TArray<uint8*> LargeBlocks;
+
+    // Index of the block currently used for the allocations
+    int32 CurrentBlock = INDEX_NONE;
+
+    // Amount of bytes used in the current block
+    SIZE_T Offset = 0;
+
+    // Amount of frames which are still alive
+    int32 NumLiveFrames = 0;
+};
+
+// Base for every Promise which can allocate it's frame from the arena. It is opt-in: a coroutine uses the arena
+// only when it's first parameter is CoroArena&, every other coroutine uses the engine allocator as usual.
+struct CoroArenaFrame
+{
+    // The global operator delete gets only the pointer and the size of the frame, so the arena is remembered
+    // in a small header placed before the frame. It is null for frames taken from the engine allocator.
+    struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) FHeader
+    {
+        CoroArena* Arena;
+    };
+
+    // Called when the coroutine frame is created and the first parameter of the coroutine function is the arena.
+    // The compiler passes all of the coroutine function parameters after the frame size.
+    template<typename... Args>
+    static void* operator new(std::size_t Size, CoroArena& Arena, Args&&...)
+    {
+        FHeader* Header = static_cast<FHeader*>(Arena.Allocate(sizeof(FHeader) + Size));
+        Header->Arena = &Arena;
+        return Header + 1;
+    }
+
+    // Called when the coroutine frame is created for every other coroutine
+    static void* operator new(std::size_t Size)
+    {
+        FHeader* Header = static_cast<FHeader*>(FMemory::Malloc(sizeof(FHeader) + Size, alignof(FHeader)));
+        Header->Arena = nullptr;
+        return Header + 1;
+    }
+
+    // Called when the coroutine frame is destroyed
+    static void operator delete(void* Ptr, std::size_t Size)
+    {
+        FHeader* Header = static_cast<FHeader*>(Ptr) - 1;
+        if (Header->Arena)
+        {
+            Header->Arena->Deallocate(Header);
+        }
+        else
+        {
+            FMemory::Free(Header);
+        }
+    }
+};
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroPromise;
+};
+
+// Definition of the coroutine Promise
+struct CoroPromise : CoroArenaFrame
+{
+    // Called in order to construct the coroutine Handle
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+
+    // Do not suspend when the coroutine starts
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    // Do not suspend when the coroutine ends
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs
+    void unhandled_exception() {}
+};
+
+// Definition of the coroutine Task used for suspending a specific amount of time, the same as in the 04_CoroUE5FadeOut.cpp sample.
+// Awaiters are stored inside the coroutine frame for the time of the suspension, so they are in the arena too.
+class WaitSecondsTask
+{
+private:
+
+    // Time left to resume
+    float TimeRemaining;
+
+    // Coroutine Handle to resume after time
+    std::coroutine_handle<CoroPromise> Handle;
+
+    // Unreal ticker handle
+    FTSTicker::FDelegateHandle TickerHandle;
+
+public:
+
+    // Task constructor which stores the amount of time to being suspended
+    WaitSecondsTask(float Time) : TimeRemaining(Time) {}
+
+    // Called when the coroutine has been resumed
+    void await_resume() {}
+
+    // Ignore suspension if the given time is invalid
+    bool await_ready() { return TimeRemaining <= 0.f; }
+
+    // Called when the coroutine has been suspended using this Task
+    void await_suspend(std::coroutine_handle<CoroPromise> CoroHandle)
+    {
+        Handle = CoroHandle;
+        TickerHandle = FTSTicker::GetCoreTicker().AddTicker(TEXT("CoroWaitSeconds"), 0.f, [this](float DeltaTime) -> bool
+        {
+            TimeRemaining -= DeltaTime;
+            if (TimeRemaining <= 0.f)
+            {
+                FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+                Handle.resume();
+            }
+            return true;
+        });
+    };
+};
+
+// Definition of the coroutine function which fades out the camera. The arena is it's first parameter,
+// so the frame is allocated from it. The parameter is not used inside the coroutine itself.
+CoroHandle CoroFadeOut(CoroArena& Arena, float StepTime)
+{
+    // Warning, there will be velociraptors: World should be obtained by a World Context Object,
+    // but just for the example sake we use nasty GWorld.
+    if (GWorld)
+    {
+        APlayerCameraManager* CameraManager = UGameplayStatics::GetPlayerCameraManager(GWorld, 0);
+        for (int32 Fade = 0; Fade <= 100; Fade += 10)
+        {
+            if (IsValid(CameraManager))
+            {
+                CameraManager->SetManualCameraFade((float)Fade * .01f, FColor::Black, false);
+            }
+            co_await WaitSecondsTask(StepTime);
+        }
+    }
+}
+
+// Gameplay system which starts short-lived coroutines in bursts. All of them are allocated from it's arena,
+// and the arena is released at once when the whole burst has finished.
+class CoroBurstSystem
+{
+public:
+
+    // Start a burst of coroutines
+    void StartBurst(int32 Amount)
+    {
+        for (int32 i = 0; i < Amount; i++)
+        {
+            CoroFadeOut(Arena, .1f * (i + 1));
+        }
+
+        if (TickerHandle.IsValid() == false)
+        {
+            TickerHandle = FTSTicker::GetCoreTicker().AddTicker(TEXT("CoroBurstSystem"), 0.f, [this](float DeltaTime) -> bool
+            {
+                // Every coroutine of the burst has ended, so all of it's memory can be given back in one shot
+                if (Arena.GetNumLiveFrames() == 0)
+                {
+                    Arena.ReleaseAll();
+                    TickerHandle.Reset();
+                    return false;
+                }
+                return true;
+            });
+        }
+    }
+
+private:
+
+    // Arena for the frames of every coroutine started by this system
+    CoroArena Arena;
+
+    // Unreal ticker handle
+    FTSTicker::FDelegateHandle TickerHandle;
+};
@@ -0,0 +1,234 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutines which can be cancelled while they are waiting.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <utility>
+
+// Queue of suspended coroutines waiting for a specific tick. Every waiting coroutine is identified by a key,
+// so it can be removed from the queue when it is cancelled, instead of being checked every tick until it expires.
+class CoroTimerQueue
+{
+public:
+
+    // Deadline of the timer and the sequence number keeping the order of timers with the same deadline
+    using FTimerKey = std::pair<uint64_t, uint64_t>;
+
+    // Suspend given coroutine Handle for the given amount of ticks
+    FTimerKey Add(uint64_t Ticks, std::coroutine_handle<> Handle)
+    {
+        const FTimerKey Key = { Now + Ticks, NextSequence++ };
+        Timers.emplace(Key, Handle);
+        return Key;
+    }
+
+    // Forget the timer of the cancelled coroutine
+    void Remove(const FTimerKey& Key)
+    {
+        Timers.erase(Key);
+    }
+
+    // Advance the clock by one tick and resume every expired coroutine
+    void Tick()
+    {
+        Now++;
+        while (Timers.empty() == false && Timers.begin()->first.first <= Now)
+        {
+            const std::coroutine_handle<> Handle = Timers.begin()->second;
+            Timers.erase(Timers.begin());
+            Handle.resume();
+        }
+    }
+
+    // Amount of coroutines currently waiting in the queue
+    std::size_t Num() const { return Timers.size(); }
+
+private:
+
+    // Current tick
+    uint64_t Now = 0;
+
+    // Sequence number for the next added timer
+    uint64_t NextSequence = 0;
+
+    // All waiting coroutines sorted by their deadlines
+    std::map<FTimerKey, std::coroutine_handle<>> Timers;
+};
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroPromise;
+};
+
+// Definition of the coroutine Promise
+struct CoroPromise
+{
+    // Called when the coroutine is created and the coroutine function gets the stop token as it's first parameter.
+    // The compiler passes all of the coroutine function parameters to the Promise constructor if it accepts them.
+    template<typename... Args>
+    CoroPromise(const std::stop_token& Token, const Args&...) : StopToken(Token) {}
+
+    // Called when the coroutine is created without the stop token. Such coroutine can't be cancelled.
+    CoroPromise() = default;
+
+    // Called in order to construct the coroutine Handle
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+
+    // Do not suspend when the coroutine starts
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    // Do not suspend when the coroutine ends
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs
+    void unhandled_exception() {}
+
+    // Token cancelling every wait of this coroutine
+    std::stop_token StopToken;
+};
+
+// Definition of the coroutine Task used for suspending a specific amount of ticks. If the coroutine is cancelled
+// during the wait, the Task removes it's timer from the queue and destroys the coroutine at once.
+// The stop callback is called on the thread which requests the stop, so in this example the stop must be requested
+// on the same thread which ticks the queue. Otherwise the queue and the coroutine would have to be guarded.
+class WaitTicksTask
+{
+private:
+
+    // Called by the stop source when the stop is requested
+    struct FCancelCallback
+    {
+        WaitTicksTask* Task;
+
+        void operator()() noexcept { Task->Cancel(); }
+    };
+
+    // Queue to wait in
+    CoroTimerQueue& Queue;
+
+    // Amount of ticks to wait
+    uint64_t Ticks;
+
+    // Coroutine Handle to destroy when cancelled
+    std::coroutine_handle<CoroPromise> Handle;
+
+    // Key of the timer in the queue
+    CoroTimerQueue::FTimerKey Key;
+
+    // Registration in the stop token. It is unregistered when the Task is destroyed after the coroutine is resumed.
+    std::optional<std::stop_callback<FCancelCallback>> Callback;
+
+    // Unlink the timer and destroy the coroutine. This Task lives inside the coroutine frame, so it can't be touched afterwards.
+    void Cancel()
+    {
+        Queue.Remove(Key);
+        Handle.destroy();
+    }
+
+public:
+
+    // Task constructor which stores the queue and the amount of ticks to being suspended
+    WaitTicksTask(CoroTimerQueue& InQueue, uint64_t InTicks) : Queue(InQueue), Ticks(InTicks) {}
+
+    // Called when the coroutine has been resumed
+    void await_resume() {}
+
+    // Indicated that coroutine can be suspended
+    bool await_ready() { return false; }
+
+    // Called when the coroutine has been suspended using this Task
+    void await_suspend(std::coroutine_handle<CoroPromise> CoroHandle)
+    {
+        Handle = CoroHandle;
+
+        // The coroutine has been cancelled before it started to wait
+        const std::stop_token& Token = Handle.promise().StopToken;
+        if (Token.stop_requested())
+        {
+            Handle.destroy();
+            return;
+        }
+
+        Key = Queue.Add(Ticks, Handle);
+        if (Token.stop_possible())
+        {
+            Callback.emplace(Token, FCancelCallback{ this });
+        }
+    };
+};
+
+// Object which prints when it is destroyed, to show the locals of the cancelled coroutine are destroyed as well
+struct ScopeLog
+{
+    std::string Name;
+    ~ScopeLog() { std::cout << Name << " destroyed\n"; }
+};
+
+// Definition of the coroutine function which fades out something in 10 steps. The stop token is not used
+// inside the coroutine, it is picked up by the Promise constructor.
+CoroHandle CoroFadeOut(std::stop_token, CoroTimerQueue& Queue, std::string Name, int& FinishedSteps)
+{
+    ScopeLog Log{ Name };
+    for (int Fade = 0; Fade < 10; Fade++)
+    {
+        co_await WaitTicksTask(Queue, 1);
+        FinishedSteps++;
+    }
+    std::cout << Name << " finished\n";
+}
+
+// Main program
+int main()
+{
+    CoroTimerQueue Queue;
+    int FinishedSteps = 0;
+
+    // Every actor has it's own stop source, which is triggered when the actor dies
+    std::stop_source FirstActor;
+    std::stop_source SecondActor;
+    CoroFadeOut(FirstActor.get_token(), Queue, "First", FinishedSteps);
+    CoroFadeOut(SecondActor.get_token(), Queue, "Second", FinishedSteps);
+
+    // The second actor dies after 3 ticks. It's coroutine is destroyed and it won't be resumed anymore.
+    for (int i = 0; i < 3; i++)
+    {
+        Queue.Tick();
+    }
+    SecondActor.request_stop();
+    std::cout << "Waiting after cancel: " << Queue.Num() << "\n";
+
+    // Tick until the first actor's coroutine has finished
+    while (Queue.Num() > 0)
+    {
+        Queue.Tick();
+    }
+    std::cout << "Finished steps: " << FinishedSteps << "\n";
+
+    return 0;
+}
+
+/**
+ The program should output:
+
+ Second destroyed
+ Waiting after cancel: 1
+ First finished
+ First destroyed
+ Finished steps: 13
+*/
@@ -0,0 +1,351 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutines which stream values to each other through a bounded channel.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Bounded channel between one producer coroutine and one consumer coroutine. Values are stored inside a lock-free
+// ring buffer. The producer suspends only when the buffer is full and the consumer suspends only when it is empty.
+// The suspended side is resumed by the other side, on the thread of the other side.
+template<typename T, std::size_t Capacity = 64>
+class AsyncChannel
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+
+    // Awaiter sending a single value
+    struct SendAwaiter
+    {
+        AsyncChannel& Channel;
+        T Value;
+        bool bSent = false;
+
+        // Don't suspend if the value fits into the buffer
+        bool await_ready() { return bSent = Channel.TryPush(Value); }
+
+        // The buffer is full, wait until the consumer takes something
+        bool await_suspend(std::coroutine_handle<> Handle)
+        {
+            return Channel.Park(Channel.WaitingProducer, Handle, &AsyncChannel::HasSpace);
+        }
+
+        // There is only one producer, so the space made by the consumer can't be taken by anyone else
+        void await_resume()
+        {
+            if (bSent == false)
+            {
+                Channel.TryPush(Value);
+            }
+        }
+    };
+
+    // Awaiter receiving a single value. It gives nothing back when the channel has been closed and all values have been received.
+    struct RecvAwaiter
+    {
+        AsyncChannel& Channel;
+        std::optional<T> Value;
+
+        bool await_ready() { return Channel.TryPop(Value) || Channel.IsClosed(); }
+
+        bool await_suspend(std::coroutine_handle<> Handle)
+        {
+            return Channel.Park(Channel.WaitingConsumer, Handle, &AsyncChannel::HasValuesOrClosed);
+        }
+
+        std::optional<T> await_resume()
+        {
+            if (Value.has_value() == false)
+            {
+                Channel.TryPop(Value);
+            }
+            return std::move(Value);
+        }
+    };
+
+    // Awaiter sending as many values as fit into the buffer at once. Returns the amount of sent values.
+    struct SendBatchAwaiter
+    {
+        AsyncChannel& Channel;
+        std::span<const T> Values;
+        std::size_t Sent = 0;
+
+        bool await_ready() { return Values.empty() || (Sent = Channel.PushBatch(Values)) > 0; }
+
+        bool await_suspend(std::coroutine_handle<> Handle)
+        {
+            return Channel.Park(Channel.WaitingProducer, Handle, &AsyncChannel::HasSpace);
+        }
+
+        std::size_t await_resume()
+        {
+            if (Sent == 0)
+            {
+                Sent = Channel.PushBatch(Values);
+            }
+            return Sent;
+        }
+    };
+
+    // Awaiter receiving as many values as are available, up to the size of the given buffer. Returns the amount
+    // of received values, which is 0 only when the channel has been closed and all values have been received.
+    struct RecvBatchAwaiter
+    {
+        AsyncChannel& Channel;
+        std::span<T> Values;
+        std::size_t Received = 0;
+
+        bool await_ready() { return Values.empty() || (Received = Channel.PopBatch(Values)) > 0 || Channel.IsClosed(); }
+
+        bool await_suspend(std::coroutine_handle<> Handle)
+        {
+            return Channel.Park(Channel.WaitingConsumer, Handle, &AsyncChannel::HasValuesOrClosed);
+        }
+
+        std::size_t await_resume()
+        {
+            if (Received == 0)
+            {
+                Received = Channel.PopBatch(Values);
+            }
+            return Received;
+        }
+    };
+
+    SendAwaiter Send(T Value) { return { *this, std::move(Value), false }; }
+    RecvAwaiter Recv() { return { *this, std::nullopt }; }
+    SendBatchAwaiter SendBatch(std::span<const T> Values) { return { *this, Values }; }
+    RecvBatchAwaiter RecvBatch(std::span<T> Values) { return { *this, Values }; }
+
+    // Tell the consumer there will be no more values. Must be called by the producer.
+    void Close()
+    {
+        bClosed.store(true, std::memory_order_seq_cst);
+        Wake(WaitingConsumer);
+    }
+
+    bool IsClosed() const { return bClosed.load(std::memory_order_seq_cst); }
+
+private:
+
+    // Producer side. Try to put the value into the buffer.
+    bool TryPush(T& Value)
+    {
+        const uint64_t T0 = Tail.load(std::memory_order_relaxed);
+        if (T0 - Head.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+        Buffer[T0 & (Capacity - 1)] = std::move(Value);
+        Publish(Tail, T0 + 1, WaitingConsumer);
+        return true;
+    }
+
+    // Producer side. Put as many values as fit into the buffer and publish all of them at once.
+    std::size_t PushBatch(std::span<const T> Values)
+    {
+        const uint64_t T0 = Tail.load(std::memory_order_relaxed);
+        const std::size_t Count = std::min<std::size_t>(Values.size(), Capacity - (T0 - Head.load(std::memory_order_acquire)));
+        for (std::size_t i = 0; i < Count; i++)
+        {
+            Buffer[(T0 + i) & (Capacity - 1)] = Values[i];
+        }
+        if (Count > 0)
+        {
+            Publish(Tail, T0 + Count, WaitingConsumer);
+        }
+        return Count;
+    }
+
+    // Consumer side. Try to take the value from the buffer.
+    bool TryPop(std::optional<T>& Value)
+    {
+        const uint64_t H0 = Head.load(std::memory_order_relaxed);
+        if (H0 == Tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        Value.emplace(std::move(Buffer[H0 & (Capacity - 1)]));
+        Publish(Head, H0 + 1, WaitingProducer);
+        return true;
+    }
+
+    // Consumer side. Take as many values as are available and fit into the given buffer.
+    std::size_t PopBatch(std::span<T> Values)
+    {
+        const uint64_t H0 = Head.load(std::memory_order_relaxed);
+        const std::size_t Count = std::min<std::size_t>(Values.size(), Tail.load(std::memory_order_acquire) - H0);
+        for (std::size_t i = 0; i < Count; i++)
+        {
+            Values[i] = std::move(Buffer[(H0 + i) & (Capacity - 1)]);
+        }
+        if (Count > 0)
+        {
+            Publish(Head, H0 + Count, WaitingProducer);
+        }
+        return Count;
+    }
+
+    bool HasSpace() const { return Tail.load(std::memory_order_seq_cst) - Head.load(std::memory_order_seq_cst) < Capacity; }
+    bool HasValuesOrClosed() const { return Tail.load(std::memory_order_seq_cst) != Head.load(std::memory_order_seq_cst) || IsClosed(); }
+
+    // Move the index forward and wake the other side if it waits for it. The index store and the waiter load
+    // are sequentially consistent, so either this side sees the waiter, or the waiter sees the new index.
+    void Publish(std::atomic<uint64_t>& Index, uint64_t Value, std::atomic<void*>& Waiter)
+    {
+        Index.store(Value, std::memory_order_seq_cst);
+        Wake(Waiter);
+    }
+
+    // Resume the waiting coroutine, if there is one. Only one side can take the Handle from the slot.
+    static void Wake(std::atomic<void*>& Waiter)
+    {
+        if (Waiter.load(std::memory_order_seq_cst) != nullptr)
+        {
+            if (void* Address = Waiter.exchange(nullptr, std::memory_order_acq_rel))
+            {
+                std::coroutine_handle<>::from_address(Address).resume();
+            }
+        }
+    }
+
+    // Put the coroutine into the waiter slot and check the condition again, because the other side could have changed it
+    // before it has seen the slot. Returns false if the coroutine doesn't have to be suspended anymore.
+    // Once the Handle is in the slot the coroutine can be resumed by the other side at any moment, so the awaiter,
+    // which lives inside the coroutine frame, can't be touched anymore. That's why the condition is a member of the channel.
+    bool Park(std::atomic<void*>& Waiter, std::coroutine_handle<> Handle, bool (AsyncChannel::*IsReady)() const)
+    {
+        Waiter.store(Handle.address(), std::memory_order_seq_cst);
+        if ((this->*IsReady)() == false)
+        {
+            return true;
+        }
+
+        // If the Handle is still in the slot nobody will resume it, so continue without suspending.
+        // Otherwise the other side has already taken it and it will resume the coroutine.
+        return Waiter.exchange(nullptr, std::memory_order_acq_rel) == nullptr;
+    }
+
+    // Indices of the next value to read and the next value to write. They only grow, the position
+    // in the buffer is the index modulo the capacity. They are on separate cache lines, so the producer and
+    // the consumer don't invalidate each other's cache when only one of them moves.
+    alignas(64) std::atomic<uint64_t> Head = 0;
+    alignas(64) std::atomic<uint64_t> Tail = 0;
+
+    // Coroutines waiting for space and for values
+    alignas(64) std::atomic<void*> WaitingProducer = nullptr;
+    alignas(64) std::atomic<void*> WaitingConsumer = nullptr;
+
+    // Set when the producer has no more values
+    std::atomic<bool> bClosed = false;
+
+    // Values waiting to be received
+    std::array<T, Capacity> Buffer = {};
+};
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroPromise;
+};
+
+// Definition of the coroutine Promise
+struct CoroPromise
+{
+    // Called in order to construct the coroutine Handle
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+
+    // Do not suspend when the coroutine starts
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    // Do not suspend when the coroutine ends
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs
+    void unhandled_exception() {}
+};
+
+// Producer sending values one by one and then in batches
+CoroHandle Producer(AsyncChannel<int, 16>& Channel, int Amount)
+{
+    for (int i = 1; i <= Amount; i++)
+    {
+        co_await Channel.Send(i);
+    }
+
+    std::vector<int> Values;
+    for (int i = Amount + 1; i <= Amount * 2; i++)
+    {
+        Values.push_back(i);
+    }
+    std::span<const int> Left = Values;
+    while (Left.empty() == false)
+    {
+        Left = Left.subspan(co_await Channel.SendBatch(Left));
+    }
+
+    Channel.Close();
+}
+
+// Consumer receiving values in batches until the channel is closed
+CoroHandle Consumer(AsyncChannel<int, 16>& Channel, int64_t& Sum, bool& bClosed)
+{
+    std::array<int, 8> Values;
+    while (const std::size_t Received = co_await Channel.RecvBatch(Values))
+    {
+        for (std::size_t i = 0; i < Received; i++)
+        {
+            Sum += Values[i];
+        }
+    }
+
+    // And a single receive which tells the channel is closed
+    const std::optional<int> Last = co_await Channel.Recv();
+    bClosed = Last.has_value() == false;
+}
+
+// Main program
+int main()
+{
+    AsyncChannel<int, 16> Channel;
+    int64_t Sum = 0;
+    bool bClosed = false;
+
+    // Both coroutines are started on their own threads. From that point every one of them is resumed by the other one,
+    // so when both threads have ended, both coroutines have finished.
+    {
+        std::jthread ConsumerThread([&]() { Consumer(Channel, Sum, bClosed); });
+        std::jthread ProducerThread([&]() { Producer(Channel, 10000); });
+    }
+
+    std::cout << "Sum: " << Sum << "\n";
+    std::cout << "Channel closed: " << bClosed << "\n";
+
+    return 0;
+}
+
+/**
+ The program should output:
+
+ Sum: 200010000
+ Channel closed: 1
+*/
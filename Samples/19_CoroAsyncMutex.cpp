@@ -0,0 +1,448 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutines which share the state using a mutex and a semaphore which suspend instead of blocking.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <latch>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Mutex which suspends the coroutine trying to lock it, instead of blocking the thread. Waiting coroutines are
+// kept in an intrusive lock-free list made of their awaiters, and unlocking hands the ownership directly to the next one.
+class AsyncMutex
+{
+public:
+
+    // Awaiter locking the mutex. It is the node of the list of waiting coroutines, so waiting doesn't allocate anything.
+    class LockAwaiter
+    {
+    public:
+
+        explicit LockAwaiter(AsyncMutex& InMutex) : Mutex(InMutex) {}
+
+        // Don't suspend if the mutex is not locked
+        bool await_ready() { return Mutex.TryLock(); }
+
+        // Lock the mutex or put this awaiter on the top of the waiting list. Returns false if the mutex has been locked.
+        bool await_suspend(std::coroutine_handle<> InHandle)
+        {
+            Handle = InHandle;
+            uintptr_t OldState = Mutex.State.load(std::memory_order_acquire);
+            for (;;)
+            {
+                if (OldState == NotLocked)
+                {
+                    if (Mutex.State.compare_exchange_weak(OldState, LockedNoWaiters, std::memory_order_acquire, std::memory_order_relaxed))
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    // After this awaiter is in the list it can be resumed at any moment, so it can't be touched anymore
+                    Next = reinterpret_cast<LockAwaiter*>(OldState);
+                    if (Mutex.State.compare_exchange_weak(OldState, reinterpret_cast<uintptr_t>(this), std::memory_order_release, std::memory_order_relaxed))
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+
+        // The coroutine is resumed already owning the mutex
+        void await_resume() {}
+
+    private:
+
+        friend class AsyncMutex;
+
+        AsyncMutex& Mutex;
+
+        // Next waiting coroutine in the list
+        LockAwaiter* Next = nullptr;
+
+        // Coroutine waiting for the mutex
+        std::coroutine_handle<> Handle;
+    };
+
+    AsyncMutex() = default;
+    AsyncMutex(const AsyncMutex&) = delete;
+    AsyncMutex& operator=(const AsyncMutex&) = delete;
+
+    // Use co_await Mutex.Lock() to lock the mutex
+    LockAwaiter Lock() { return LockAwaiter(*this); }
+
+    // Lock the mutex only if it is not locked
+    bool TryLock()
+    {
+        uintptr_t OldState = NotLocked;
+        return State.compare_exchange_strong(OldState, LockedNoWaiters, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    // Unlock the mutex. If there are waiting coroutines the first one becomes the owner and it is resumed
+    // on the calling thread, before this function returns. Must be called by the owner of the mutex.
+    void Unlock()
+    {
+        LockAwaiter* Waiter = Waiters;
+        if (Waiter == nullptr)
+        {
+            // Nobody waits, so the mutex can be simply unlocked
+            uintptr_t OldState = LockedNoWaiters;
+            if (State.compare_exchange_strong(OldState, NotLocked, std::memory_order_release, std::memory_order_relaxed))
+            {
+                return;
+            }
+
+            // Take all coroutines waiting in the list at once. The list is the stack, so it is reversed
+            // in order to resume the coroutines in the order they have started waiting.
+            OldState = State.exchange(LockedNoWaiters, std::memory_order_acquire);
+            LockAwaiter* List = reinterpret_cast<LockAwaiter*>(OldState);
+            while (List)
+            {
+                LockAwaiter* Next = List->Next;
+                List->Next = Waiter;
+                Waiter = List;
+                List = Next;
+            }
+        }
+
+        // The list taken from the state is touched only by the owner of the mutex
+        Waiters = Waiter->Next;
+        Waiter->Handle.resume();
+    }
+
+private:
+
+    // State of the mutex: not locked, locked without waiting coroutines, or the pointer to the lastly added waiting coroutine
+    static constexpr uintptr_t NotLocked = 1;
+    static constexpr uintptr_t LockedNoWaiters = 0;
+    std::atomic<uintptr_t> State = NotLocked;
+
+    // Waiting coroutines taken from the state, in the order they should get the mutex
+    LockAwaiter* Waiters = nullptr;
+};
+
+// Semaphore which suspends the coroutine when there are no free permits. It works like the AsyncMutex, but
+// the state is either the amount of free permits or the list of waiting coroutines.
+class AsyncSemaphore
+{
+public:
+
+    // Awaiter acquiring one permit. It is the node of the list of waiting coroutines.
+    class AcquireAwaiter
+    {
+    public:
+
+        explicit AcquireAwaiter(AsyncSemaphore& InSemaphore) : Semaphore(InSemaphore) {}
+
+        // Don't suspend if there is a free permit
+        bool await_ready() { return Semaphore.TryAcquire(); }
+
+        // Take the permit or put this awaiter on the top of the waiting list. Returns false if the permit has been taken.
+        bool await_suspend(std::coroutine_handle<> InHandle)
+        {
+            Handle = InHandle;
+            uintptr_t OldState = Semaphore.State.load(std::memory_order_acquire);
+            for (;;)
+            {
+                if (IsPermits(OldState) && OldState != ToState(0))
+                {
+                    if (Semaphore.State.compare_exchange_weak(OldState, OldState - 2, std::memory_order_acquire, std::memory_order_relaxed))
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    Next = IsPermits(OldState) ? nullptr : reinterpret_cast<AcquireAwaiter*>(OldState);
+                    if (Semaphore.State.compare_exchange_weak(OldState, reinterpret_cast<uintptr_t>(this), std::memory_order_release, std::memory_order_relaxed))
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+
+        // The coroutine is resumed already owning the permit
+        void await_resume() {}
+
+    private:
+
+        friend class AsyncSemaphore;
+
+        AsyncSemaphore& Semaphore;
+        AcquireAwaiter* Next = nullptr;
+        std::coroutine_handle<> Handle;
+    };
+
+    // Constructor - set the initial amount of free permits
+    explicit AsyncSemaphore(uintptr_t Permits) : State(ToState(Permits)) {}
+    AsyncSemaphore(const AsyncSemaphore&) = delete;
+    AsyncSemaphore& operator=(const AsyncSemaphore&) = delete;
+
+    // Use co_await Semaphore.Acquire() to take one permit
+    AcquireAwaiter Acquire() { return AcquireAwaiter(*this); }
+
+    // Take the permit only if there is a free one
+    bool TryAcquire()
+    {
+        uintptr_t OldState = State.load(std::memory_order_relaxed);
+        while (IsPermits(OldState) && OldState != ToState(0))
+        {
+            if (State.compare_exchange_weak(OldState, OldState - 2, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Give the permit back. If there are waiting coroutines the permit is given directly to the first one.
+    // Any thread can release, but only one of them at a time hands permits to the waiting coroutines. Other threads
+    // only count their releases and the one which hands permits processes them as well, so no thread waits for another.
+    void Release()
+    {
+        if (PendingReleases.fetch_add(1, std::memory_order_acq_rel) != 0)
+        {
+            return;
+        }
+        do
+        {
+            ReleaseOne();
+        }
+        while (PendingReleases.fetch_sub(1, std::memory_order_acq_rel) != 1);
+    }
+
+private:
+
+    // The lowest bit tells if the state is the amount of free permits (shifted by one) or the pointer to the lastly added waiter.
+    // Awaiters are aligned, so their addresses never have the lowest bit set.
+    static constexpr uintptr_t ToState(uintptr_t Permits) { return (Permits << 1) | 1; }
+    static constexpr bool IsPermits(uintptr_t State) { return (State & 1) != 0; }
+
+    // Give one permit to the first waiting coroutine or, if nobody waits, to the state
+    void ReleaseOne()
+    {
+        AcquireAwaiter* Waiter = Waiters;
+        if (Waiter == nullptr)
+        {
+            uintptr_t OldState = State.load(std::memory_order_relaxed);
+            while (IsPermits(OldState))
+            {
+                if (State.compare_exchange_weak(OldState, OldState + 2, std::memory_order_release, std::memory_order_relaxed))
+                {
+                    return;
+                }
+            }
+
+            // Coroutines wait only when there are no free permits, so taking them leaves no free permits
+            OldState = State.exchange(ToState(0), std::memory_order_acquire);
+            AcquireAwaiter* List = reinterpret_cast<AcquireAwaiter*>(OldState);
+            while (List)
+            {
+                AcquireAwaiter* Next = List->Next;
+                List->Next = Waiter;
+                Waiter = List;
+                List = Next;
+            }
+        }
+
+        // The list taken from the state is touched only by the thread which hands out the permits
+        Waiters = Waiter->Next;
+        Waiter->Handle.resume();
+    }
+
+    // Amount of free permits or the pointer to the lastly added waiting coroutine
+    std::atomic<uintptr_t> State;
+
+    // Amount of releases which have not been handled yet
+    std::atomic<uint32_t> PendingReleases = 0;
+
+    // Waiting coroutines taken from the state, in the order they should get the permits
+    AcquireAwaiter* Waiters = nullptr;
+};
+
+// Simple thread pool with one shared queue, so the coroutines can run on many threads.
+// Check the 09_CoroThreadPool.cpp sample for the one which doesn't use the mutex.
+class CoroThreadPool
+{
+public:
+
+    // Awaiter which continues the coroutine on one of the workers
+    struct ScheduleAwaiter
+    {
+        CoroThreadPool& Pool;
+
+        bool await_ready() { return false; }
+        void await_suspend(std::coroutine_handle<> Handle) { Pool.Push(Handle); }
+        void await_resume() {}
+    };
+
+    // Constructor - start the worker threads
+    explicit CoroThreadPool(int NumWorkers)
+    {
+        for (int i = 0; i < NumWorkers; i++)
+        {
+            Workers.emplace_back([this](std::stop_token Token) { Run(Token); });
+        }
+    }
+
+    // Destructor - stop and join the worker threads
+    ~CoroThreadPool()
+    {
+        for (std::jthread& Worker : Workers)
+        {
+            Worker.request_stop();
+        }
+        Condition.notify_all();
+    }
+
+    // Use co_await Pool.Schedule() to continue the coroutine on the pool
+    ScheduleAwaiter Schedule() { return { *this }; }
+
+private:
+
+    void Push(std::coroutine_handle<> Handle)
+    {
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            Queue.push_back(Handle);
+        }
+        Condition.notify_one();
+    }
+
+    void Run(std::stop_token Token)
+    {
+        for (;;)
+        {
+            std::coroutine_handle<> Handle;
+            {
+                std::unique_lock<std::mutex> Lock(Mutex);
+                if (Condition.wait(Lock, Token, [this]() { return Queue.empty() == false; }) == false)
+                {
+                    return;
+                }
+                Handle = Queue.front();
+                Queue.pop_front();
+            }
+            Handle.resume();
+        }
+    }
+
+    std::mutex Mutex;
+    std::condition_variable_any Condition;
+    std::deque<std::coroutine_handle<>> Queue;
+    std::vector<std::jthread> Workers;
+};
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroPromise;
+};
+
+// Definition of the coroutine Promise
+struct CoroPromise
+{
+    // Called in order to construct the coroutine Handle
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+
+    // Do not suspend when the coroutine starts
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    // Do not suspend when the coroutine ends
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs
+    void unhandled_exception() {}
+};
+
+// Coroutine incrementing the shared counter, which is not atomic, so it must be guarded by the mutex
+CoroHandle IncrementCoroutine(CoroThreadPool& Pool, AsyncMutex& Mutex, int64_t& Counter, int Amount, std::latch& Done)
+{
+    for (int i = 0; i < Amount; i++)
+    {
+        co_await Pool.Schedule();
+        co_await Mutex.Lock();
+        Counter++;
+        Mutex.Unlock();
+    }
+    Done.count_down();
+}
+
+// Coroutine doing the work which can't be done by more than a few coroutines at once
+CoroHandle LimitedCoroutine(CoroThreadPool& Pool, AsyncSemaphore& Semaphore, std::atomic<int>& InFlight, std::atomic<int>& MaxInFlight, std::latch& Done)
+{
+    co_await Pool.Schedule();
+    co_await Semaphore.Acquire();
+
+    const int Current = InFlight.fetch_add(1) + 1;
+    int Max = MaxInFlight.load();
+    while (Current > Max && MaxInFlight.compare_exchange_weak(Max, Current) == false) {}
+
+    // Permit is kept while the coroutine moves to another worker
+    co_await Pool.Schedule();
+
+    InFlight.fetch_sub(1);
+    Semaphore.Release();
+    Done.count_down();
+}
+
+// Main program
+int main()
+{
+    constexpr int NumCoroutines = 100;
+    constexpr int NumIncrements = 100;
+    constexpr int MaxPermits = 3;
+
+    AsyncMutex Mutex;
+    int64_t Counter = 0;
+    std::latch MutexDone(NumCoroutines);
+
+    AsyncSemaphore Semaphore(MaxPermits);
+    std::atomic<int> InFlight = 0;
+    std::atomic<int> MaxInFlight = 0;
+    std::latch SemaphoreDone(NumCoroutines);
+
+    // The pool is declared as the last one, so it's workers are joined before the mutex and the semaphore are destroyed
+    CoroThreadPool Pool(4);
+
+    // Every coroutine increments the counter many times, on different workers
+    for (int i = 0; i < NumCoroutines; i++)
+    {
+        IncrementCoroutine(Pool, Mutex, Counter, NumIncrements, MutexDone);
+    }
+    MutexDone.wait();
+    std::cout << "Counter: " << Counter << "\n";
+
+    // Only a few coroutines can hold the permit at the same time
+    for (int i = 0; i < NumCoroutines; i++)
+    {
+        LimitedCoroutine(Pool, Semaphore, InFlight, MaxInFlight, SemaphoreDone);
+    }
+    SemaphoreDone.wait();
+    std::cout << "Permits never exceeded: " << (MaxInFlight.load() <= MaxPermits) << "\n";
+
+    return 0;
+}
+
+/**
+ The program should output:
+
+ Counter: 10000
+ Permits never exceeded: 1
+*/
@@ -0,0 +1,248 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of coroutines in Unreal Engine 5 which are resumed on the game thread within a per-frame time budget.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <coroutine>
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Kismet/GameplayStatics.h"
+
+// Time in milliseconds the scheduler can spend resuming coroutines in a single frame
+static TAutoConsoleVariable<float> CVarCoroFrameBudgetMs(
+    TEXT("coro.FrameBudgetMs"),
+    2.f,
+    TEXT("Time in milliseconds the coroutine scheduler can spend resuming coroutines in a single frame."));
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroPromise;
+};
+
+// Definition of the coroutine Promise
+struct CoroPromise
+{
+    // Called in order to construct the coroutine Handle
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+
+    // Do not suspend when the coroutine starts
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    // Do not suspend when the coroutine ends
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs
+    void unhandled_exception() {}
+};
+
+// Priority of the resumed coroutine. Coroutines with higher priority are resumed first when the budget is tight.
+enum class ECoroPriority : uint8
+{
+    Low,
+    Normal,
+    High
+};
+
+// Statistics of the scheduler, useful to tune the budget
+struct FCoroSchedulerStats
+{
+    // Amount of coroutines resumed in the last frame
+    int32 NumResumed = 0;
+
+    // Amount of ready coroutines which didn't fit into the budget of the last frame and were moved to the next one
+    int32 NumDeferred = 0;
+
+    // Time spent on resuming coroutines in the last frame, in milliseconds
+    double TimeMs = 0.0;
+
+    // The biggest amount of deferred coroutines in a single frame since the start
+    int32 MaxDeferred = 0;
+
+    // Amount of frames in which at least one coroutine was deferred
+    int64 NumFramesOverBudget = 0;
+};
+
+// Scheduler of all coroutines waiting on the game thread. It keeps the waiting coroutines sorted by their deadlines,
+// the same as the CoroTimerQueue from the 06_CoroUE5TimerQueue.cpp sample. Expired coroutines are not resumed at once though,
+// they are moved to the ready queue sorted by their priority, which is drained only until the frame budget is spent.
+class CoroGameThreadScheduler
+{
+public:
+
+    // Get the one and only scheduler
+    static CoroGameThreadScheduler& Get()
+    {
+        static CoroGameThreadScheduler Scheduler;
+        return Scheduler;
+    }
+
+    // Suspend given coroutine Handle until the given amount of time passes
+    void Add(float Time, ECoroPriority Priority, std::coroutine_handle<> Handle)
+    {
+        check(IsInGameThread());
+
+        // Start the Unreal ticker with the first waiting coroutine
+        if (TickerHandle.IsValid() == false)
+        {
+            TickerHandle = FTSTicker::GetCoreTicker().AddTicker(TEXT("CoroGameThreadScheduler"), 0.f, [this](float DeltaTime) -> bool
+            {
+                Tick(DeltaTime);
+                return true;
+            });
+        }
+
+        Timers.HeapPush({ CurrentTime + Time, NextSequence++, Priority, Handle }, FTimerPredicate());
+    }
+
+    // Statistics of the last frame
+    const FCoroSchedulerStats& GetStats() const { return Stats; }
+
+private:
+
+    // Single suspended coroutine, it's deadline and it's priority
+    struct FEntry
+    {
+        double Deadline;
+
+        // Keeps the order of entries with the same deadline and priority, so they are resumed in the order they were added
+        uint64 Sequence;
+
+        ECoroPriority Priority;
+
+        std::coroutine_handle<> Handle;
+    };
+
+    // Orders the timers heap so the earliest deadline is always on top
+    struct FTimerPredicate
+    {
+        bool operator()(const FEntry& A, const FEntry& B) const
+        {
+            return A.Deadline < B.Deadline || (A.Deadline == B.Deadline && A.Sequence < B.Sequence);
+        }
+    };
+
+    // Orders the ready heap so the highest priority is always on top. Entries with the same priority
+    // are resumed in the order they were added, so deferred coroutines don't starve behind newer ones.
+    struct FReadyPredicate
+    {
+        bool operator()(const FEntry& A, const FEntry& B) const
+        {
+            return A.Priority > B.Priority || (A.Priority == B.Priority && A.Sequence < B.Sequence);
+        }
+    };
+
+    // Called once per frame by the Unreal ticker
+    void Tick(float DeltaTime)
+    {
+        CurrentTime += DeltaTime;
+
+        // Move every expired coroutine to the ready queue. It costs only a heap operation per coroutine.
+        while (Timers.Num() > 0 && Timers.HeapTop().Deadline <= CurrentTime)
+        {
+            FEntry Entry;
+            Timers.HeapPop(Entry, FTimerPredicate());
+            Ready.HeapPush(Entry, FReadyPredicate());
+        }
+
+        // Resume ready coroutines until the budget is spent. At least one coroutine is resumed every frame,
+        // so the coroutines make progress even if the budget is smaller than the cost of a single resume.
+        const double StartTime = FPlatformTime::Seconds();
+        const double EndTime = StartTime + CVarCoroFrameBudgetMs.GetValueOnGameThread() * .001;
+        int32 NumResumed = 0;
+        while (Ready.Num() > 0 && (NumResumed == 0 || FPlatformTime::Seconds() < EndTime))
+        {
+            FEntry Entry;
+            Ready.HeapPop(Entry, FReadyPredicate());
+            Entry.Handle.resume();
+            NumResumed++;
+        }
+
+        // Whatever is left in the ready queue is resumed in the next frame, before anything which expires later
+        Stats.NumResumed = NumResumed;
+        Stats.NumDeferred = Ready.Num();
+        Stats.TimeMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+        Stats.MaxDeferred = FMath::Max(Stats.MaxDeferred, Stats.NumDeferred);
+        if (Stats.NumDeferred > 0)
+        {
+            Stats.NumFramesOverBudget++;
+        }
+    }
+
+    // Time accumulated from all ticks
+    double CurrentTime = 0.0;
+
+    // Sequence number for the next added timer
+    uint64 NextSequence = 0;
+
+    // Waiting coroutines kept as a min-heap of deadlines
+    TArray<FEntry> Timers;
+
+    // Expired coroutines kept as a max-heap of priorities
+    TArray<FEntry> Ready;
+
+    // Statistics of the last frame
+    FCoroSchedulerStats Stats;
+
+    // Unreal ticker handle
+    FTSTicker::FDelegateHandle TickerHandle;
+};
+
+// Definition of the coroutine Task used for suspending a specific amount of time
+class WaitSecondsTask
+{
+private:
+
+    // Time to wait before resume
+    float Time;
+
+    // Priority of the resume when the time has passed
+    ECoroPriority Priority;
+
+public:
+
+    // Task constructor which stores the amount of time to being suspended and the priority
+    WaitSecondsTask(float InTime, ECoroPriority InPriority = ECoroPriority::Normal) : Time(InTime), Priority(InPriority) {}
+
+    // Called when the coroutine has been resumed
+    void await_resume() {}
+
+    // Ignore suspension if the given time is invalid
+    bool await_ready() { return Time <= 0.f; }
+
+    // Called when the coroutine has been suspended using this Task
+    void await_suspend(std::coroutine_handle<CoroPromise> CoroHandle)
+    {
+        CoroGameThreadScheduler::Get().Add(Time, Priority, CoroHandle);
+    };
+};
+
+// Definition of the coroutine function which fades out the camera. The camera fade is visible to the player,
+// so it waits with the high priority and it is not deferred behind less important coroutines.
+CoroHandle CoroFadeOut()
+{
+    // Warning, there will be velociraptors: World should be obtained by a World Context Object,
+    // but just for the example sake we use nasty GWorld.
+    if (GWorld)
+    {
+        APlayerCameraManager* CameraManager = UGameplayStatics::GetPlayerCameraManager(GWorld, 0);
+        for (int32 Fade = 0; Fade <= 100; Fade += 10)
+        {
+            // Because the WaitSecondsTask can tick between worlds we can't be sure if the Camera Manager
+            // is valid all the time.
+            if (IsValid(CameraManager))
+            {
+                CameraManager->SetManualCameraFade((float)Fade * .01f, FColor::Black, false);
+            }
+            co_await WaitSecondsTask(.1f, ECoroPriority::High);
+        }
+    }
+}
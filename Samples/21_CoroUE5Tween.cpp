@@ -0,0 +1,272 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of coroutines in Unreal Engine 5 which wait for tweens evaluated all at once by a single system.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <coroutine>
+#include "Containers/Ticker.h"
+#include "Kismet/GameplayStatics.h"
+#include "Math/VectorRegister.h"
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroPromise;
+};
+
+// Definition of the coroutine Promise
+struct CoroPromise
+{
+    // Called in order to construct the coroutine Handle
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+
+    // Do not suspend when the coroutine starts
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    // Do not suspend when the coroutine ends
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs
+    void unhandled_exception() {}
+};
+
+// System evaluating every active tween once per frame. Tweens are stored as a structure of arrays, so
+// the interpolation of all of them is a single pass over contiguous floats, done four tweens at once with SIMD.
+// The coroutine waiting for the tween is resumed only once, when the tween has finished.
+class CoroTweenSystem
+{
+public:
+
+    // Get the one and only tween system
+    static CoroTweenSystem& Get()
+    {
+        static CoroTweenSystem System;
+        return System;
+    }
+
+    // Start the tween which writes the value directly to the given float, or calls the given setter, every frame
+    void Add(float* Target, TFunction<void(float)>&& Setter, float From, float To, float Duration, std::coroutine_handle<> Handle)
+    {
+        check(IsInGameThread());
+
+        // Start the Unreal ticker with the first tween
+        if (TickerHandle.IsValid() == false)
+        {
+            TickerHandle = FTSTicker::GetCoreTicker().AddTicker(TEXT("CoroTweenSystem"), 0.f, [this](float DeltaTime) -> bool
+            {
+                Tick(DeltaTime);
+                return true;
+            });
+        }
+
+        Froms.Add(From);
+        Deltas.Add(To - From);
+        Elapsed.Add(0.f);
+        InvDurations.Add(1.f / Duration);
+        Values.Add(From);
+        Targets.Add(Target);
+        Setters.Add(MoveTemp(Setter));
+        Handles.Add(Handle);
+    }
+
+    // Amount of currently active tweens
+    int32 Num() const { return Handles.Num(); }
+
+private:
+
+    // Called once per frame by the Unreal ticker
+    void Tick(float DeltaTime)
+    {
+        const int32 NumTweens = Handles.Num();
+        Evaluate(DeltaTime, NumTweens);
+
+        // Apply the values. The tweens writing directly to a float don't need any call.
+        for (int32 i = 0; i < NumTweens; i++)
+        {
+            if (Targets[i])
+            {
+                *Targets[i] = Values[i];
+            }
+            else
+            {
+                Setters[i](Values[i]);
+            }
+        }
+
+        // Remove finished tweens by swapping them with the last ones, so the arrays stay contiguous. The coroutines
+        // are resumed after the arrays are compacted, because they can start new tweens.
+        for (int32 i = NumTweens - 1; i >= 0; i--)
+        {
+            if (Elapsed[i] * InvDurations[i] >= 1.f)
+            {
+                Finished.Add(Handles[i]);
+                RemoveAtSwap(i);
+            }
+        }
+        for (const std::coroutine_handle<> Handle : Finished)
+        {
+            Handle.resume();
+        }
+        Finished.Reset();
+    }
+
+    // Advance every tween and compute it's current value: From + Delta * Min(Elapsed / Duration, 1)
+    void Evaluate(float DeltaTime, int32 NumTweens)
+    {
+        float* RESTRICT FromPtr = Froms.GetData();
+        float* RESTRICT DeltaPtr = Deltas.GetData();
+        float* RESTRICT ElapsedPtr = Elapsed.GetData();
+        float* RESTRICT InvDurationPtr = InvDurations.GetData();
+        float* RESTRICT ValuePtr = Values.GetData();
+
+        const VectorRegister4Float DeltaTimeVec = VectorSetFloat1(DeltaTime);
+        const VectorRegister4Float OneVec = VectorOne();
+
+        int32 i = 0;
+        for (; i + 4 <= NumTweens; i += 4)
+        {
+            const VectorRegister4Float ElapsedVec = VectorAdd(VectorLoad(ElapsedPtr + i), DeltaTimeVec);
+            VectorStore(ElapsedVec, ElapsedPtr + i);
+
+            const VectorRegister4Float Alpha = VectorMin(VectorMultiply(ElapsedVec, VectorLoad(InvDurationPtr + i)), OneVec);
+            VectorStore(VectorMultiplyAdd(VectorLoad(DeltaPtr + i), Alpha, VectorLoad(FromPtr + i)), ValuePtr + i);
+        }
+
+        // The rest of the tweens which don't fill the whole vector
+        for (; i < NumTweens; i++)
+        {
+            ElapsedPtr[i] += DeltaTime;
+            const float Alpha = FMath::Min(ElapsedPtr[i] * InvDurationPtr[i], 1.f);
+            ValuePtr[i] = FromPtr[i] + DeltaPtr[i] * Alpha;
+        }
+    }
+
+    // Remove the tween from every array
+    void RemoveAtSwap(int32 Index)
+    {
+        Froms.RemoveAtSwap(Index);
+        Deltas.RemoveAtSwap(Index);
+        Elapsed.RemoveAtSwap(Index);
+        InvDurations.RemoveAtSwap(Index);
+        Values.RemoveAtSwap(Index);
+        Targets.RemoveAtSwap(Index);
+        Setters.RemoveAtSwap(Index);
+        Handles.RemoveAtSwap(Index);
+    }
+
+    // Data used by the evaluation pass, one array per field
+    TArray<float> Froms;
+    TArray<float> Deltas;
+    TArray<float> Elapsed;
+    TArray<float> InvDurations;
+    TArray<float> Values;
+
+    // Data used only when applying the values and finishing the tweens
+    TArray<float*> Targets;
+    TArray<TFunction<void(float)>> Setters;
+    TArray<std::coroutine_handle<>> Handles;
+
+    // Coroutines of the tweens finished in the current frame
+    TArray<std::coroutine_handle<>> Finished;
+
+    // Unreal ticker handle
+    FTSTicker::FDelegateHandle TickerHandle;
+};
+
+// Definition of the coroutine Task used for suspending until the tween has finished
+class TweenTask
+{
+private:
+
+    // Tween parameters, given to the tween system when the coroutine is suspended
+    float* Target;
+    TFunction<void(float)> Setter;
+    float From;
+    float To;
+    float Duration;
+
+public:
+
+    // Task constructor for the tween writing directly to the given float
+    TweenTask(float& InTarget, float InFrom, float InTo, float InDuration) :
+        Target(&InTarget), From(InFrom), To(InTo), Duration(InDuration)
+    {}
+
+    // Task constructor for the tween calling the given setter
+    TweenTask(TFunction<void(float)>&& InSetter, float InFrom, float InTo, float InDuration) :
+        Target(nullptr), Setter(MoveTemp(InSetter)), From(InFrom), To(InTo), Duration(InDuration)
+    {}
+
+    // Called when the coroutine has been resumed
+    void await_resume() {}
+
+    // Ignore suspension if the given duration is invalid
+    bool await_ready()
+    {
+        if (Duration > 0.f)
+        {
+            return false;
+        }
+
+        // Nothing to interpolate, just set the final value
+        if (Target)
+        {
+            *Target = To;
+        }
+        else
+        {
+            Setter(To);
+        }
+        return true;
+    }
+
+    // Called when the coroutine has been suspended using this Task
+    void await_suspend(std::coroutine_handle<CoroPromise> CoroHandle)
+    {
+        CoroTweenSystem::Get().Add(Target, MoveTemp(Setter), From, To, Duration, CoroHandle);
+    };
+};
+
+// Use co_await Tween(...) to interpolate the value and wait until it's done
+TweenTask Tween(float& Target, float From, float To, float Duration) { return TweenTask(Target, From, To, Duration); }
+TweenTask Tween(TFunction<void(float)> Setter, float From, float To, float Duration) { return TweenTask(MoveTemp(Setter), From, To, Duration); }
+
+// Definition of the coroutine function which fades out the camera. Instead of waking up 11 times to set the next
+// step of the fade, it is resumed once, when the fade has finished, and the fade itself is smooth.
+CoroHandle CoroFadeOut()
+{
+    // Warning, there will be velociraptors: World should be obtained by a World Context Object,
+    // but just for the example sake we use nasty GWorld.
+    if (GWorld)
+    {
+        // Because the tween can tick between worlds we can't be sure if the Camera Manager
+        // is valid all the time, so we keep a weak pointer to it.
+        TWeakObjectPtr<APlayerCameraManager> CameraManager = UGameplayStatics::GetPlayerCameraManager(GWorld, 0);
+        co_await Tween([CameraManager](float Fade)
+        {
+            if (CameraManager.IsValid())
+            {
+                CameraManager->SetManualCameraFade(Fade, FColor::Black, false);
+            }
+        }, 0.f, 1.f, 1.f);
+    }
+}
+
+// Definition of the coroutine function which pulses the given value, for example the intensity of a light,
+// for the given amount of times. The value is written directly, so the system doesn't need to call anything,
+// but the value must outlive the coroutine.
+CoroHandle CoroPulse(float& Intensity, int32 Times)
+{
+    for (int32 i = 0; i < Times; i++)
+    {
+        co_await Tween(Intensity, 0.f, 1.f, .25f);
+        co_await Tween(Intensity, 1.f, 0.f, .25f);
+    }
+}
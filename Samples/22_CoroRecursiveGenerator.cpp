@@ -0,0 +1,377 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutine generator which can yield all values of another generator at once.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <utility>
+
+// Amount of coroutine resumes, so the cost of the traversals can be compared
+static uint64_t NumResumes = 0;
+
+// Regular Generator, the same as in the 03_CoroGenerators.cpp sample
+template<typename T>
+struct CoroGenerator
+{
+    struct CoroPromise;
+    using promise_type = CoroPromise;
+    using CoroHandle = std::coroutine_handle<CoroPromise>;
+
+    struct CoroPromise
+    {
+        const T* Value = nullptr;
+
+        CoroGenerator get_return_object() { return CoroGenerator(CoroHandle::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() {}
+
+        std::suspend_always yield_value(const T& from)
+        {
+            Value = std::addressof(from);
+            return {};
+        }
+    };
+
+    class Iterator
+    {
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+        explicit Iterator(CoroHandle InHandle) : Handle(InHandle) {}
+
+        const T& operator*() const { return *Handle.promise().Value; }
+        Iterator& operator++()
+        {
+            NumResumes++;
+            Handle.resume();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+        bool operator==(std::default_sentinel_t) const { return Handle.done(); }
+
+    private:
+        CoroHandle Handle;
+    };
+
+    Iterator begin()
+    {
+        NumResumes++;
+        Handle.resume();
+        return Iterator(Handle);
+    }
+    std::default_sentinel_t end() { return {}; }
+
+    explicit CoroGenerator(CoroHandle InHandle) : Handle(InHandle) {}
+    CoroGenerator(const CoroGenerator&) = delete;
+    CoroGenerator& operator=(const CoroGenerator&) = delete;
+    CoroGenerator(CoroGenerator&& Other) noexcept : Handle(std::exchange(Other.Handle, {})) {}
+    ~CoroGenerator()
+    {
+        if (Handle)
+        {
+            Handle.destroy();
+        }
+    }
+
+private:
+    CoroHandle Handle;
+};
+
+// Forward declaration of the recursive Generator, so it can be used by ElementsOf
+template<typename T>
+struct CoroRecursiveGenerator;
+
+// Wrapper telling the recursive Generator to yield all values of the given Generator: co_yield ElementsOf(Child)
+template<typename T>
+struct ElementsOf
+{
+    // The constructor is intentional. GCC 12 destroys the aggregate temporary created inside the co_yield expression twice,
+    // which here would destroy the nested Generator twice. A temporary created by a constructor is destroyed correctly.
+    explicit ElementsOf(CoroRecursiveGenerator<T>&& InGenerator) : Generator(std::move(InGenerator)) {}
+
+    CoroRecursiveGenerator<T> Generator;
+};
+
+// Definition of the recursive Generator. Generators nested with ElementsOf form a stack, from the outermost one,
+// which is iterated by the consumer, to the innermost one, which currently yields values. The outermost one
+// remembers the innermost one, so the consumer resumes it directly, no matter how deep the stack is.
+template<typename T>
+struct CoroRecursiveGenerator
+{
+    // Forward declaration of the Promise so it can be used for a Handle definition
+    struct CoroPromise;
+
+    // Tell the Generator to use our Promise
+    using promise_type = CoroPromise;
+
+    // Convinient alias for the coroutine Handle type which uses declared Promise
+    using CoroHandle = std::coroutine_handle<CoroPromise>;
+
+    // Definition of the Generator Promise
+    struct CoroPromise
+    {
+        // Pointer to the lastly yielded value. Used only in the outermost Generator.
+        const T* Value = nullptr;
+
+        // The outermost Generator of the stack. It points to itself in the outermost Generator.
+        CoroPromise* Root = this;
+
+        // Generator which has nested this Generator, or null in the outermost Generator
+        CoroHandle Parent;
+
+        // The innermost Generator which should be resumed to get the next value. Used only in the outermost Generator.
+        CoroHandle Leaf;
+
+        // Awaiter which returns to the parent Generator, when the nested one has finished
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept { return false; }
+
+            // Symmetric transfer to the parent, so the parent continues right after it's co_yield ElementsOf.
+            // The outermost Generator simply stays suspended, so the consumer can see it's done.
+            std::coroutine_handle<> await_suspend(CoroHandle Handle) noexcept
+            {
+                CoroPromise& Promise = Handle.promise();
+                if (Promise.Parent)
+                {
+                    Promise.Root->Leaf = Promise.Parent;
+                    NumResumes++;
+                    return Promise.Parent;
+                }
+                return std::noop_coroutine();
+            }
+
+            void await_resume() noexcept {}
+        };
+
+        // Awaiter which starts the nested Generator. The nested Generator is owned by the ElementsOf given to the co_yield,
+        // which lives until the whole co_yield expression has finished, so until the nested Generator has finished.
+        struct NestedAwaiter
+        {
+            CoroHandle Nested;
+
+            bool await_ready() noexcept { return false; }
+
+            // Make the nested Generator the innermost one and start it by the symmetric transfer
+            std::coroutine_handle<> await_suspend(CoroHandle Handle) noexcept
+            {
+                CoroPromise& NestedPromise = Nested.promise();
+                NestedPromise.Root = Handle.promise().Root;
+                NestedPromise.Parent = Handle;
+                NestedPromise.Root->Leaf = Nested;
+                NumResumes++;
+                return Nested;
+            }
+
+            void await_resume() noexcept {}
+        };
+
+        // Called in order to construct the Generator
+        CoroRecursiveGenerator get_return_object() { return CoroRecursiveGenerator(CoroHandle::from_promise(*this)); }
+
+        // Suspend the Generator at the beginning
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // Suspend the Generator at the end and go back to the parent
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        // Called when co_return is used
+        void return_void() {}
+
+        // Called when exception occurs
+        void unhandled_exception() {}
+
+        // Called when co_yield is used with a value. The value is given directly to the outermost Generator,
+        // and the suspension goes back directly to the consumer.
+        std::suspend_always yield_value(const T& from)
+        {
+            Root->Value = std::addressof(from);
+            return {};
+        }
+
+        // Called when co_yield is used with ElementsOf
+        NestedAwaiter yield_value(const ElementsOf<T>& Elements) noexcept
+        {
+            return NestedAwaiter{ Elements.Generator.Handle };
+        }
+    };
+
+    // Iterator which resumes the innermost Generator and gives access to the lastly yielded value
+    class Iterator
+    {
+    public:
+
+        // Types required by the std::input_iterator concept
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        // Iterators must be default constructible in order to be used with std::ranges
+        Iterator() = default;
+
+        // Constructor - remember the Handle of the outermost Generator
+        explicit Iterator(CoroHandle InHandle) : Handle(InHandle) {}
+
+        // Get the lastly yielded value, stored in the outermost Generator
+        const T& operator*() const { return *Handle.promise().Value; }
+
+        // Resume the innermost Generator. It's parents are not resumed at all.
+        Iterator& operator++()
+        {
+            NumResumes++;
+            Handle.promise().Leaf.resume();
+            return *this;
+        }
+
+        // Post increment doesn't have to return anything for input iterators
+        void operator++(int) { ++*this; }
+
+        // Iterator reached the end when the outermost Generator has finished
+        bool operator==(std::default_sentinel_t) const { return Handle.done(); }
+
+    private:
+
+        // Handle of the outermost Generator
+        CoroHandle Handle;
+    };
+
+    // Start the Generator and get the Iterator to the first yielded value
+    Iterator begin()
+    {
+        Handle.promise().Leaf = Handle;
+        NumResumes++;
+        Handle.resume();
+        return Iterator(Handle);
+    }
+
+    // The end of the Generator is represented by the default sentinel
+    std::default_sentinel_t end() { return {}; }
+
+    // Constructor - save the coroutine Handle given during the get_return_object call in the Promise
+    explicit CoroRecursiveGenerator(CoroHandle InHandle) : Handle(InHandle) {}
+
+    // Generator owns the coroutine Handle, so it can be only moved
+    CoroRecursiveGenerator(const CoroRecursiveGenerator&) = delete;
+    CoroRecursiveGenerator& operator=(const CoroRecursiveGenerator&) = delete;
+    CoroRecursiveGenerator(CoroRecursiveGenerator&& Other) noexcept : Handle(std::exchange(Other.Handle, {})) {}
+
+    // Destructor - explicitly destroy the coroutine Handle. Destroying the outermost Generator in the middle
+    // of the co_yield ElementsOf destroys the ElementsOf, which destroys the nested Generator, so the whole stack is destroyed.
+    ~CoroRecursiveGenerator()
+    {
+        if (Handle)
+        {
+            Handle.destroy();
+        }
+    }
+
+private:
+
+    // Stores the coroutine Handle used within this Generator
+    CoroHandle Handle;
+};
+
+// Node of the binary tree
+struct TreeNode
+{
+    int Value;
+    std::unique_ptr<TreeNode> Left;
+    std::unique_ptr<TreeNode> Right;
+};
+
+// Build the balanced tree of values from First to Last
+std::unique_ptr<TreeNode> BuildTree(int First, int Last)
+{
+    if (First > Last)
+    {
+        return nullptr;
+    }
+    const int Middle = First + (Last - First) / 2;
+    return std::unique_ptr<TreeNode>(new TreeNode{ Middle, BuildTree(First, Middle - 1), BuildTree(Middle + 1, Last) });
+}
+
+// Walk the tree in order using the regular Generator. Every value is yielded again by every ancestor.
+CoroGenerator<int> WalkNested(const TreeNode* Node)
+{
+    if (Node == nullptr)
+    {
+        co_return;
+    }
+    for (const int Value : WalkNested(Node->Left.get()))
+    {
+        co_yield Value;
+    }
+    co_yield Node->Value;
+    for (const int Value : WalkNested(Node->Right.get()))
+    {
+        co_yield Value;
+    }
+}
+
+// Walk the tree in order using the recursive Generator. Every value is yielded once, directly to the consumer.
+CoroRecursiveGenerator<int> WalkRecursive(const TreeNode* Node)
+{
+    if (Node == nullptr)
+    {
+        co_return;
+    }
+    co_yield ElementsOf(WalkRecursive(Node->Left.get()));
+    co_yield Node->Value;
+    co_yield ElementsOf(WalkRecursive(Node->Right.get()));
+}
+
+// The recursive Generator can be used with every range algorithm and view
+static_assert(std::ranges::input_range<CoroRecursiveGenerator<int>>);
+
+// Sum the values of the Generator and print the amount of resumes it needed
+template<typename Generator>
+void PrintWalk(const char* Name, Generator&& Walk)
+{
+    NumResumes = 0;
+    int64_t Sum = 0;
+    int Count = 0;
+    for (const int Value : Walk)
+    {
+        Sum += Value;
+        Count++;
+    }
+    std::cout << Name << ": " << Count << " values, sum " << Sum << ", " << NumResumes << " resumes\n";
+}
+
+// Main program
+int main()
+{
+    // Balanced tree of 1023 values is 10 levels deep
+    const std::unique_ptr<TreeNode> Tree = BuildTree(1, 1023);
+
+    PrintWalk("Nested", WalkNested(Tree.get()));
+    PrintWalk("Recursive", WalkRecursive(Tree.get()));
+
+    // Stop the iteration in the middle of the stack. Destroying the outermost Generator destroys the nested ones.
+    CoroRecursiveGenerator<int> Walk = WalkRecursive(Tree.get());
+    std::cout << "First values:";
+    for (const int Value : Walk | std::views::take(5))
+    {
+        std::cout << " " << Value;
+    }
+    std::cout << "\n";
+
+    return 0;
+}
+
+/**
+ The program should output:
+
+ Nested: 1023 values, sum 523776, 11264 resumes
+ Recursive: 1023 values, sum 523776, 5116 resumes
+ First values: 1 2 3 4 5
+*/
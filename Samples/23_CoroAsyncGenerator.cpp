@@ -0,0 +1,281 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutine generator which can wait for asynchronous operations between yields.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// Simple event loop which resumes suspended coroutines one by one, in the order they were suspended.
+// It stands in for the real I/O loop, like the CoroIoContext from the 13_CoroAsyncIO.cpp sample.
+class CoroEventLoop
+{
+public:
+
+    // Fake stream which gives at most the given amount of bytes per read, like a socket receiving a long response
+    struct FakeStream
+    {
+        std::string_view Data;
+        std::size_t ChunkSize;
+        std::size_t Offset = 0;
+    };
+
+    // Awaiter of a single read. It always suspends, so the read completes in one of the next loop iterations.
+    struct ReadAwaiter
+    {
+        CoroEventLoop& Loop;
+        FakeStream& Stream;
+        std::span<char> Buffer;
+
+        bool await_ready() noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> Handle) { Loop.Ready.push_back(Handle); }
+
+        // Copy the next chunk into the buffer. Returns the amount of read bytes, 0 at the end of the stream.
+        std::size_t await_resume() noexcept
+        {
+            const std::size_t Size = std::min({ Buffer.size(), Stream.ChunkSize, Stream.Data.size() - Stream.Offset });
+            std::copy_n(Stream.Data.data() + Stream.Offset, Size, Buffer.data());
+            Stream.Offset += Size;
+            return Size;
+        }
+    };
+
+    // Use co_await Loop.AsyncRead(Stream, Buffer) to read the next chunk of the stream
+    ReadAwaiter AsyncRead(FakeStream& Stream, std::span<char> Buffer) { return { *this, Stream, Buffer }; }
+
+    // Resume coroutines until there is nothing left to resume
+    void Run()
+    {
+        while (Ready.empty() == false)
+        {
+            const std::coroutine_handle<> Handle = Ready.front();
+            Ready.pop_front();
+            Handle.resume();
+        }
+    }
+
+private:
+
+    // Coroutines which can be resumed
+    std::deque<std::coroutine_handle<>> Ready;
+};
+
+// Definition of the asynchronous Generator. It can co_await anything between yields, so the consumer can't simply
+// resume it and read the value, like with the regular Generator. Instead, the consumer awaits the next value
+// with co_await Generator.Next(), and the Generator resumes the consumer when the value is ready.
+template<typename T>
+class AsyncGenerator
+{
+public:
+
+    // Forward declaration of the Promise so it can be used for a Handle definition
+    struct CoroPromise;
+
+    // Tell the Generator to use our Promise
+    using promise_type = CoroPromise;
+
+    // Convinient alias for the coroutine Handle type which uses declared Promise
+    using CoroHandle = std::coroutine_handle<CoroPromise>;
+
+    // Definition of the Generator Promise
+    struct CoroPromise
+    {
+        // Pointer to the lastly yielded value. It is valid until the next value is awaited.
+        const T* Value = nullptr;
+
+        // Coroutine which awaits the next value
+        std::coroutine_handle<> Consumer;
+
+        // Exception thrown inside the Generator, rethrown to the consumer
+        std::exception_ptr Exception;
+
+        // Awaiter used by co_yield and at the end of the Generator. It transfers the execution directly to the consumer.
+        struct ConsumerAwaiter
+        {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(CoroHandle Handle) noexcept { return Handle.promise().Consumer; }
+            void await_resume() noexcept {}
+        };
+
+        // Called in order to construct the Generator
+        AsyncGenerator get_return_object() { return AsyncGenerator(CoroHandle::from_promise(*this)); }
+
+        // Suspend the Generator at the beginning, it starts when the first value is awaited
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // Go back to the consumer at the end, so it knows there are no more values
+        ConsumerAwaiter final_suspend() noexcept { return {}; }
+
+        // Called when co_return is used
+        void return_void() {}
+
+        // Called when exception occurs. Remember it, so it can be rethrown to the consumer.
+        void unhandled_exception() { Exception = std::current_exception(); }
+
+        // Called when co_yield is used. Remember the value and give it to the consumer.
+        // The yielded value lives until the Generator is resumed again, so the pointer to it is safe.
+        ConsumerAwaiter yield_value(const T& from)
+        {
+            Value = std::addressof(from);
+            return {};
+        }
+    };
+
+    // Awaiter of the next value
+    struct NextAwaiter
+    {
+        CoroHandle Handle;
+
+        // The finished Generator has no more values, so there is no need to suspend
+        bool await_ready() noexcept { return Handle.done(); }
+
+        // Remember the consumer and transfer the execution to the Generator, which runs until it yields or finishes
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> Consumer) noexcept
+        {
+            Handle.promise().Consumer = Consumer;
+            return Handle;
+        }
+
+        // Returns the pointer to the yielded value, or null if the Generator has finished
+        const T* await_resume()
+        {
+            CoroPromise& Promise = Handle.promise();
+            if (Promise.Exception)
+            {
+                std::rethrow_exception(std::exchange(Promise.Exception, {}));
+            }
+            return Handle.done() ? nullptr : Promise.Value;
+        }
+    };
+
+    // Use co_await Generator.Next() to get the pointer to the next value, or null if there are no more values
+    NextAwaiter Next() { return { Handle }; }
+
+    // Constructor - save the coroutine Handle given during the get_return_object call in the Promise
+    explicit AsyncGenerator(CoroHandle InHandle) : Handle(InHandle) {}
+
+    // Generator owns the coroutine Handle, so it can be only moved
+    AsyncGenerator(const AsyncGenerator&) = delete;
+    AsyncGenerator& operator=(const AsyncGenerator&) = delete;
+    AsyncGenerator(AsyncGenerator&& Other) noexcept : Handle(std::exchange(Other.Handle, {})) {}
+
+    // Destructor - explicitly destroy the coroutine Handle. The Generator must not be destroyed
+    // while it waits for an asynchronous operation, because the operation would resume the destroyed coroutine.
+    ~AsyncGenerator()
+    {
+        if (Handle)
+        {
+            Handle.destroy();
+        }
+    }
+
+private:
+
+    // Stores the coroutine Handle used within this Generator
+    CoroHandle Handle;
+};
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroPromise;
+};
+
+// Definition of the coroutine Promise
+struct CoroPromise
+{
+    // Called in order to construct the coroutine Handle
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+
+    // Do not suspend when the coroutine starts
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    // Do not suspend when the coroutine ends
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs
+    void unhandled_exception() {}
+};
+
+// Asynchronous Generator which reads the stream chunk by chunk and yields it's lines. Only one chunk and one
+// unfinished line are kept in the memory, no matter how long the stream is.
+AsyncGenerator<std::string_view> ReadLines(CoroEventLoop& Loop, CoroEventLoop::FakeStream& Stream)
+{
+    char Chunk[8];
+    std::string Line;
+    while (const std::size_t Read = co_await Loop.AsyncRead(Stream, Chunk))
+    {
+        std::cout << "Read " << Read << " bytes\n";
+        for (std::size_t i = 0; i < Read; i++)
+        {
+            if (Chunk[i] == '\n')
+            {
+                co_yield Line;
+                Line.clear();
+            }
+            else
+            {
+                Line.push_back(Chunk[i]);
+            }
+        }
+    }
+
+    // The last line doesn't have to end with the new line
+    if (Line.empty() == false)
+    {
+        co_yield Line;
+    }
+}
+
+// Consumer which processes every line as soon as it was read
+CoroHandle PrintLines(CoroEventLoop& Loop, CoroEventLoop::FakeStream& Stream)
+{
+    AsyncGenerator<std::string_view> Lines = ReadLines(Loop, Stream);
+    while (const std::string_view* Line = co_await Lines.Next())
+    {
+        std::cout << "Line: " << *Line << "\n";
+    }
+    std::cout << "End of stream\n";
+}
+
+// Main program
+int main()
+{
+    CoroEventLoop Loop;
+    CoroEventLoop::FakeStream Stream = { "id,fruit\n1,apple\n2,banana\n3,cherry", 8 };
+
+    PrintLines(Loop, Stream);
+    Loop.Run();
+
+    return 0;
+}
+
+/**
+ The program should output:
+
+ Read 8 bytes
+ Read 8 bytes
+ Line: id,fruit
+ Read 8 bytes
+ Line: 1,apple
+ Read 8 bytes
+ Line: 2,banana
+ Read 2 bytes
+ Line: 3,cherry
+ End of stream
+*/
@@ -0,0 +1,330 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutine tasks which report errors with std::expected instead of exceptions.
+// It works even with exceptions disabled. std::expected requires c++23.
+// Compile it with: g++ -std=c++23 -fno-exceptions 24_CoroExpected.cpp
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <coroutine>
+#include <exception>
+#include <expected>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+// Forward declaration of the Task so it can be used inside the Promise
+template<typename T, typename E>
+class ExpectedTask;
+
+// Common part of the Promise of every Task with the same error type
+template<typename E>
+struct ExpectedPromiseBase
+{
+    // Awaiter used when the Task finishes. It transfers the execution directly to the awaiting coroutine.
+    // If the Task has failed and it was awaited with Try, the error is passed to the awaiting Task instead.
+    struct FinalAwaiter
+    {
+        bool await_ready() noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> Handle) noexcept
+        {
+            Promise& Self = Handle.promise();
+            if (Self.ErrorParent && Self.HasError())
+            {
+                return Self.ErrorParent->Fail(Self.TakeError());
+            }
+            return Self.Continuation;
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    // Coroutine which awaits this Task
+    std::coroutine_handle<> Continuation = std::noop_coroutine();
+
+    // Task which awaits this Task with Try, so it fails together with this Task
+    ExpectedPromiseBase* ErrorParent = nullptr;
+
+    // Finish the Task with the given error without resuming it. It stays suspended where it has failed, and
+    // the execution goes directly to the first awaiting coroutine which doesn't use Try. It costs one branch per
+    // awaiting Task, there is no stack unwinding. Returns the coroutine which should be resumed next.
+    std::coroutine_handle<> Fail(E&& Error) noexcept
+    {
+        if (ErrorParent)
+        {
+            return ErrorParent->Fail(std::move(Error));
+        }
+        SetError(std::move(Error));
+        return Continuation;
+    }
+
+    // Suspend the Task at the beginning, so it starts only when awaited
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    // Transfer the execution to the awaiting coroutine at the end
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    // Errors are returned, not thrown, so an exception is a bug
+    void unhandled_exception() noexcept { std::terminate(); }
+
+protected:
+
+    // Store the error as the result of the Task
+    virtual void SetError(E&& Error) noexcept = 0;
+
+    // Promises are never deleted through the base
+    ~ExpectedPromiseBase() = default;
+};
+
+// Definition of the Task Promise. The result is a value or an error.
+template<typename T, typename E>
+struct ExpectedPromise final : ExpectedPromiseBase<E>
+{
+    std::optional<std::expected<T, E>> Result;
+
+    ExpectedTask<T, E> get_return_object();
+
+    // Called when co_return is used with the value, the std::unexpected or the whole std::expected
+    template<typename From>
+    void return_value(From&& from) { Result.emplace(std::forward<From>(from)); }
+
+    bool HasError() const noexcept { return Result->has_value() == false; }
+    E TakeError() noexcept { return std::move(Result->error()); }
+
+protected:
+
+    void SetError(E&& Error) noexcept override { Result.emplace(std::unexpect, std::move(Error)); }
+};
+
+// Definition of the lazy Task which gives std::expected. Use co_await Task to get the whole std::expected,
+// or co_await Try(Task) to get the value and fail the awaiting Task right away if there is an error.
+template<typename T, typename E>
+class ExpectedTask
+{
+public:
+
+    using promise_type = ExpectedPromise<T, E>;
+    using CoroHandle = std::coroutine_handle<promise_type>;
+
+    explicit ExpectedTask(CoroHandle InHandle) : Handle(InHandle) {}
+    ExpectedTask(ExpectedTask&& Other) noexcept : Handle(std::exchange(Other.Handle, {})) {}
+    ExpectedTask(const ExpectedTask&) = delete;
+    ExpectedTask& operator=(const ExpectedTask&) = delete;
+
+    // Destroying the Task which has failed inside the Try also destroys the failed Task it was awaiting
+    ~ExpectedTask()
+    {
+        if (Handle)
+        {
+            Handle.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> Awaiting) noexcept
+    {
+        Handle.promise().Continuation = Awaiting;
+        return Handle;
+    }
+
+    std::expected<T, E> await_resume() noexcept { return GetResult(); }
+
+    // Start the top level Task
+    void Start() { Handle.resume(); }
+
+    // The failed Task is not done, because it is never resumed after the failure, so check if it has the result instead
+    bool IsReady() const noexcept { return Handle.promise().Result.has_value(); }
+
+    std::expected<T, E> GetResult() noexcept { return std::move(*Handle.promise().Result); }
+
+private:
+
+    template<typename U, typename F>
+    friend class TryTaskAwaiter;
+
+    CoroHandle Handle;
+};
+
+template<typename T, typename E>
+ExpectedTask<T, E> ExpectedPromise<T, E>::get_return_object() { return ExpectedTask<T, E>(ExpectedTask<T, E>::CoroHandle::from_promise(*this)); }
+
+// Awaiter of the std::expected given by a regular function. It doesn't suspend if there is a value.
+template<typename T, typename E>
+class TryValueAwaiter
+{
+public:
+
+    // The constructor works around the same GCC 12 double destruction of aggregate temporaries as ElementsOf
+    // in the 22_CoroRecursiveGenerator.cpp sample, here for the temporary created inside the co_await expression.
+    explicit TryValueAwaiter(std::expected<T, E>&& InValue) : Value(std::move(InValue)) {}
+
+    bool await_ready() const noexcept { return Value.has_value(); }
+
+    // There is an error, so fail the awaiting Task and go where it's result is awaited
+    template<typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> Handle) noexcept
+    {
+        return Handle.promise().Fail(std::move(Value.error()));
+    }
+
+    T await_resume() noexcept { return std::move(*Value); }
+
+private:
+
+    std::expected<T, E> Value;
+};
+
+// Awaiter of the Task which passes it's error to the awaiting Task
+template<typename T, typename E>
+class TryTaskAwaiter
+{
+public:
+
+    explicit TryTaskAwaiter(ExpectedTask<T, E>&& InTask) : Task(std::move(InTask)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    // Start the Task. If it fails, it fails the awaiting Task too, so this coroutine is resumed only with the value.
+    template<typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> Handle) noexcept
+    {
+        ExpectedPromise<T, E>& TaskPromise = Task.Handle.promise();
+        TaskPromise.Continuation = Handle;
+        TaskPromise.ErrorParent = &Handle.promise();
+        return Task.Handle;
+    }
+
+    T await_resume() noexcept { return std::move(**Task.Handle.promise().Result); }
+
+private:
+
+    ExpectedTask<T, E> Task;
+};
+
+// Use co_await Try(...) to get the value, or to fail the current Task with the error
+template<typename T, typename E>
+TryValueAwaiter<T, E> Try(std::expected<T, E> Value) { return TryValueAwaiter<T, E>(std::move(Value)); }
+
+template<typename T, typename E>
+TryTaskAwaiter<T, E> Try(ExpectedTask<T, E>&& Task) { return TryTaskAwaiter<T, E>(std::move(Task)); }
+
+// Errors of the config parser
+enum class EParseError
+{
+    Empty,
+    NotANumber,
+    UnknownKey
+};
+
+const char* ToString(EParseError Error)
+{
+    switch (Error)
+    {
+        case EParseError::Empty: return "Empty";
+        case EParseError::NotANumber: return "NotANumber";
+        case EParseError::UnknownKey: return "UnknownKey";
+    }
+    return "";
+}
+
+// Regular function which reports the error with std::expected
+std::expected<int, EParseError> ParseNumber(std::string_view Text)
+{
+    if (Text.empty())
+    {
+        return std::unexpected(EParseError::Empty);
+    }
+    int Value = 0;
+    for (const char Char : Text)
+    {
+        if (Char < '0' || Char > '9')
+        {
+            return std::unexpected(EParseError::NotANumber);
+        }
+        Value = Value * 10 + (Char - '0');
+    }
+    return Value;
+}
+
+// Task parsing a single "key=value" entry. Only known keys are accepted.
+ExpectedTask<int, EParseError> ParseEntry(std::string_view Entry)
+{
+    const std::size_t Separator = Entry.find('=');
+    const std::string_view Key = Entry.substr(0, Separator);
+    if (Separator == std::string_view::npos || (Key != "port" && Key != "threads" && Key != "timeout"))
+    {
+        co_return std::unexpected(EParseError::UnknownKey);
+    }
+
+    // If the value is not a number this Task fails here and the next line is never executed
+    const int Value = co_await Try(ParseNumber(Entry.substr(Separator + 1)));
+    std::cout << "  " << Key << " = " << Value << "\n";
+    co_return Value;
+}
+
+// Task parsing the whole "key=value;key=value" config and summing up all values
+ExpectedTask<int, EParseError> ParseConfig(std::string_view Config)
+{
+    int Sum = 0;
+    while (Config.empty() == false)
+    {
+        const std::size_t Separator = Config.find(';');
+        Sum += co_await Try(ParseEntry(Config.substr(0, Separator)));
+        Config = Separator == std::string_view::npos ? std::string_view() : Config.substr(Separator + 1);
+    }
+    co_return Sum;
+}
+
+// Task which handles the error itself, by awaiting the whole std::expected
+ExpectedTask<int, EParseError> ParseConfigOrDefault(std::string_view Config, int Default)
+{
+    const std::expected<int, EParseError> Result = co_await ParseConfig(Config);
+    co_return Result.value_or(Default);
+}
+
+// Run the top level Task and print it's result
+void PrintResult(std::string_view Config, ExpectedTask<int, EParseError>&& Task)
+{
+    std::cout << "Parsing \"" << Config << "\"\n";
+    Task.Start();
+    const std::expected<int, EParseError> Result = Task.GetResult();
+    if (Result.has_value())
+    {
+        std::cout << "Sum: " << *Result << "\n";
+    }
+    else
+    {
+        std::cout << "Error: " << ToString(Result.error()) << "\n";
+    }
+}
+
+// Main program
+int main()
+{
+    PrintResult("port=8080;threads=4", ParseConfig("port=8080;threads=4"));
+    PrintResult("port=8080;timeout=x;threads=4", ParseConfig("port=8080;timeout=x;threads=4"));
+    PrintResult("port=8080;colour=red", ParseConfig("port=8080;colour=red"));
+    PrintResult("threads=", ParseConfigOrDefault("threads=", 1));
+
+    return 0;
+}
+
+/**
+ The program should output:
+
+ Parsing "port=8080;threads=4"
+   port = 8080
+   threads = 4
+ Sum: 8084
+ Parsing "port=8080;timeout=x;threads=4"
+   port = 8080
+ Error: NotANumber
+ Parsing "port=8080;colour=red"
+   port = 8080
+ Error: UnknownKey
+ Parsing "threads="
+ Sum: 1
+*/
@@ -0,0 +1,233 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutines which record the sizes of their frames, so they can be checked against a budget.
+// Frame sizes depend on the compiler and the optimization level. Only frames allocated on the heap are recorded,
+// because when the compiler elides the allocation (HALO) the operator new is not called and the size is never seen.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <source_location>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Set to 1 to assert in debug builds when a coroutine frame is bigger than the budget
+#ifndef CORO_ASSERT_FRAME_BUDGET
+#define CORO_ASSERT_FRAME_BUDGET 0
+#endif
+
+// Registry of the frame sizes of every coroutine function. The compiler decides the size of the frame, and
+// the only place where it can be seen is the operator new of the Promise, so the Promise records it here.
+class CoroFrameRegistry
+{
+public:
+
+    // Frame statistics of a single coroutine function
+    struct FEntry
+    {
+        std::string_view Name;
+        std::size_t Size = 0;
+        uint64_t NumAllocations = 0;
+    };
+
+    // Get the one and only registry
+    static CoroFrameRegistry& Get()
+    {
+        static CoroFrameRegistry Registry;
+        return Registry;
+    }
+
+    // Frames bigger than this amount of bytes are reported. The default is two cache lines.
+    void SetBudget(std::size_t InBudget) { Budget = InBudget; }
+    std::size_t GetBudget() const { return Budget; }
+
+    // Record the allocation of the frame of the given coroutine function
+    void Record(std::string_view Name, std::size_t Size)
+    {
+#if CORO_ASSERT_FRAME_BUDGET
+        assert(Size <= Budget && "Coroutine frame is over the budget");
+#endif
+        std::lock_guard<std::mutex> Lock(Mutex);
+        FEntry& Entry = Entries[Name];
+        Entry.Name = Name;
+        Entry.Size = std::max(Entry.Size, Size);
+        Entry.NumAllocations++;
+    }
+
+    // Get the statistics of every recorded coroutine function, the biggest frames first, then by name
+    std::vector<FEntry> GetEntries()
+    {
+        std::vector<FEntry> Result;
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            for (const auto& [Name, Entry] : Entries)
+            {
+                Result.push_back(Entry);
+            }
+        }
+        std::sort(Result.begin(), Result.end(), [](const FEntry& A, const FEntry& B) { return A.Size > B.Size || (A.Size == B.Size && A.Name < B.Name); });
+        return Result;
+    }
+
+private:
+
+    std::size_t Budget = 128;
+    std::mutex Mutex;
+    std::unordered_map<std::string_view, FEntry> Entries;
+};
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroPromise;
+};
+
+// Definition of the coroutine Promise
+struct CoroPromise
+{
+    // The compiler decides the size of the frame and gives it only to the operator new, before the Promise
+    // is constructed, so it is passed to the Promise constructor through the thread local variable.
+    // The constructor resets it, so it stays 0 in the coroutine which frame allocation has been elided.
+    static inline thread_local std::size_t LastFrameSize = 0;
+
+    // Size of the frame of this coroutine, or 0 if it is not allocated on the heap
+    std::size_t FrameSize;
+
+    static void* operator new(std::size_t Size)
+    {
+        LastFrameSize = Size;
+        return ::operator new(Size);
+    }
+
+    static void operator delete(void* Ptr) { ::operator delete(Ptr); }
+
+    // Called when the coroutine is created. The default argument is evaluated inside the coroutine function, so it gives
+    // the name of the coroutine function, the same as in the 12_CoroTracing.cpp sample, and the frame is recorded under it.
+    // The constructor is also needed, because without it the Promise is an aggregate and the compiler would try
+    // to initialize it's members with the parameters of the coroutine function.
+    CoroPromise(std::source_location Location = std::source_location::current()) : FrameSize(std::exchange(LastFrameSize, 0))
+    {
+        if (FrameSize > 0)
+        {
+            CoroFrameRegistry::Get().Record(Location.function_name(), FrameSize);
+        }
+    }
+
+    // Called in order to construct the coroutine Handle
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+
+    // Do not suspend when the coroutine starts
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    // Suspend when the coroutine ends, so the frame must be destroyed by the owner of the Handle
+    std::suspend_always final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs
+    void unhandled_exception() {}
+
+};
+
+// Small coroutine which keeps only a few integers across the suspension
+CoroHandle CoroTest(int Value)
+{
+    int Sum = Value;
+    co_await std::suspend_always();
+    Sum += Value;
+    std::cout << "CoroTest: " << Sum << "\n";
+}
+
+// Coroutine which keeps the big local buffer across the suspension, so the whole buffer lives in the frame
+CoroHandle CoroBigLocal(int Value)
+{
+    char Buffer[256];
+    std::fill(std::begin(Buffer), std::end(Buffer), static_cast<char>(Value));
+    co_await std::suspend_always();
+    std::cout << "CoroBigLocal: " << static_cast<int>(Buffer[255]) << "\n";
+}
+
+// The same coroutine, but the buffer is not needed after the suspension, so it lives on the stack
+// of a regular function and only the result is kept in the frame
+int FillAndSum(int Value)
+{
+    char Buffer[256];
+    std::fill(std::begin(Buffer), std::end(Buffer), static_cast<char>(Value));
+    return Buffer[255];
+}
+
+CoroHandle CoroSmallLocal(int Value)
+{
+    const int Result = FillAndSum(Value);
+    co_await std::suspend_always();
+    std::cout << "CoroSmallLocal: " << Result << "\n";
+}
+
+// Coroutine without parameters, it is recorded the same way
+CoroHandle CoroNoParameters()
+{
+    co_await std::suspend_always();
+    std::cout << "CoroNoParameters\n";
+}
+
+// Main program
+int main()
+{
+    std::vector<CoroHandle> Handles;
+    for (int i = 0; i < 3; i++)
+    {
+        Handles.push_back(CoroTest(i));
+    }
+    Handles.push_back(CoroBigLocal(7));
+    Handles.push_back(CoroSmallLocal(7));
+    Handles.push_back(CoroNoParameters());
+
+    for (CoroHandle Handle : Handles)
+    {
+        Handle.resume();
+        Handle.destroy();
+    }
+
+    // Print every coroutine function with the size of it's frame and the size class of the frame pool
+    // from the 05_CoroFramePool.cpp sample which would serve it
+    CoroFrameRegistry& Registry = CoroFrameRegistry::Get();
+    for (const CoroFrameRegistry::FEntry& Entry : Registry.GetEntries())
+    {
+        std::size_t SizeClass = 64;
+        while (SizeClass < Entry.Size)
+        {
+            SizeClass *= 2;
+        }
+        std::cout << Entry.Name << ": " << Entry.Size << " bytes, " << Entry.NumAllocations << " frames, size class " << SizeClass
+            << (Entry.Size > Registry.GetBudget() ? ", over the budget" : "") << "\n";
+    }
+
+    return 0;
+}
+
+/**
+ The program should output (frame sizes are from gcc 12):
+
+ CoroTest: 0
+ CoroTest: 2
+ CoroTest: 4
+ CoroBigLocal: 7
+ CoroSmallLocal: 7
+ CoroNoParameters
+ CoroHandle CoroBigLocal(int): 304 bytes, 1 frames, size class 512, over the budget
+ CoroHandle CoroSmallLocal(int): 56 bytes, 1 frames, size class 64
+ CoroHandle CoroTest(int): 56 bytes, 3 frames, size class 64
+ CoroHandle CoroNoParameters(): 40 bytes, 1 frames, size class 64
+*/
@@ -0,0 +1,166 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of coroutine in Unreal Engine 5 which moves between the game thread and background threads.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <coroutine>
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+#include "Kismet/GameplayStatics.h"
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroPromise;
+};
+
+// Definition of the coroutine Promise
+struct CoroPromise
+{
+    // Called in order to construct the coroutine Handle
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+
+    // Do not suspend when the coroutine starts
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    // Do not suspend when the coroutine ends
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs
+    void unhandled_exception() {}
+};
+
+// Definition of the coroutine Task which resumes the coroutine on the given named thread of the task graph.
+// The task only resumes the coroutine, so it captures nothing but the Handle, which fits inside the inline
+// storage of the task function, and the task itself comes from the task graph's own small task allocator.
+class ResumeOnThreadTask
+{
+private:
+
+    // Thread to continue the coroutine on
+    ENamedThreads::Type Thread;
+
+public:
+
+    // Task constructor which stores the thread to continue the coroutine on
+    ResumeOnThreadTask(ENamedThreads::Type InThread) : Thread(InThread) {}
+
+    // Called when the coroutine has been resumed
+    void await_resume() {}
+
+    // Don't suspend if the coroutine is already on the right thread
+    bool await_ready()
+    {
+        const bool bWantsGameThread = (Thread & ENamedThreads::ThreadIndexMask) == ENamedThreads::GameThread;
+        return IsInGameThread() == bWantsGameThread;
+    }
+
+    // Called when the coroutine has been suspended using this Task. It costs exactly one task per hop.
+    void await_suspend(std::coroutine_handle<CoroPromise> CoroHandle)
+    {
+        AsyncTask(Thread, [CoroHandle]()
+        {
+            CoroHandle.resume();
+        });
+    };
+};
+
+// Use co_await ResumeOnBackground() and co_await ResumeOnGameThread() to continue the coroutine on the other thread
+ResumeOnThreadTask ResumeOnBackground() { return ResumeOnThreadTask(ENamedThreads::AnyBackgroundThreadNormalTask); }
+ResumeOnThreadTask ResumeOnGameThread() { return ResumeOnThreadTask(ENamedThreads::GameThread); }
+
+// Definition of the coroutine Task used for suspending a specific amount of time, the same as in the 04_CoroUE5FadeOut.cpp sample.
+// The core ticker ticks on the game thread, so the coroutine is resumed on the game thread too.
+class WaitSecondsTask
+{
+private:
+
+    // Time left to resume
+    float TimeRemaining;
+
+    // Coroutine Handle to resume after time
+    std::coroutine_handle<CoroPromise> Handle;
+
+    // Unreal ticker handle
+    FTSTicker::FDelegateHandle TickerHandle;
+
+public:
+
+    // Task constructor which stores the amount of time to being suspended
+    WaitSecondsTask(float Time) : TimeRemaining(Time) {}
+
+    // Called when the coroutine has been resumed
+    void await_resume() {}
+
+    // Ignore suspension if the given time is invalid
+    bool await_ready() { return TimeRemaining <= 0.f; }
+
+    // Called when the coroutine has been suspended using this Task
+    void await_suspend(std::coroutine_handle<CoroPromise> CoroHandle)
+    {
+        // Remember the coroutine Handle
+        Handle = CoroHandle;
+
+        // Start the Unreal ticker
+        TickerHandle = FTSTicker::GetCoreTicker().AddTicker(TEXT("CoroWaitSeconds"), 0.f, [this](float DeltaTime) -> bool
+        {
+            // When the ticker ticks for the desired amount of time...
+            TimeRemaining -= DeltaTime;
+            if (TimeRemaining <= 0.f)
+            {
+                // ... stop the Unreal ticker and resume the coroutine
+                FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+                Handle.resume();
+            }
+            return true;
+        });
+    };
+};
+
+// Expensive computation which shouldn't stall the game thread. It computes the smooth fade curve.
+TArray<float> ComputeFadeCurve(int32 NumSteps)
+{
+    TArray<float> Curve;
+    Curve.Reserve(NumSteps + 1);
+    for (int32 i = 0; i <= NumSteps; i++)
+    {
+        Curve.Add(FMath::InterpEaseInOut(0.f, 1.f, (float)i / (float)NumSteps, 2.f));
+    }
+    return Curve;
+}
+
+// Definition of the coroutine function which fades out the camera. It starts on the game thread, computes the fade
+// on the background thread, and goes back to the game thread to step through the fade, because the Camera Manager
+// is not thread safe.
+CoroHandle CoroFadeOut()
+{
+    // Warning, there will be velociraptors: World should be obtained by a World Context Object,
+    // but just for the example sake we use nasty GWorld.
+    if (GWorld)
+    {
+        // Because the coroutine can continue between worlds we can't be sure if the Camera Manager
+        // is valid all the time, so we keep a weak pointer to it.
+        TWeakObjectPtr<APlayerCameraManager> CameraManager = UGameplayStatics::GetPlayerCameraManager(GWorld, 0);
+
+        co_await ResumeOnBackground();
+        const TArray<float> Curve = ComputeFadeCurve(20);
+
+        // Apply one value of the curve every .05 second, so the whole fade takes one second
+        co_await ResumeOnGameThread();
+        for (float Fade : Curve)
+        {
+            if (CameraManager.IsValid())
+            {
+                CameraManager->SetManualCameraFade(Fade, FColor::Black, false);
+            }
+            co_await WaitSecondsTask(.05f);
+        }
+    }
+}
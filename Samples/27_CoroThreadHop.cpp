@@ -0,0 +1,304 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutine which moves between the main thread and background threads.
+// It is the portable version of the 26_CoroUE5ThreadHop.cpp sample.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Node of the thread queues. It is embedded inside the awaiter, so moving a coroutine to another thread doesn't allocate anything.
+struct CoroHopNode
+{
+    // Next node in the queue
+    CoroHopNode* Next = nullptr;
+
+    // Coroutine to resume when the node is popped from the queue
+    std::coroutine_handle<> Handle;
+};
+
+// Lock-free queue of coroutines which should be resumed on the main thread, the same as the CoroReadyQueue
+// from the 10_CoroReadyQueue.cpp sample. Any thread can push to it, but only the main thread drains it.
+class CoroMainThreadQueue
+{
+public:
+
+    // Get the one and only main thread queue
+    static CoroMainThreadQueue& Get()
+    {
+        static CoroMainThreadQueue Queue;
+        return Queue;
+    }
+
+    // Remember the calling thread as the main thread
+    void SetMainThread() { MainThread = std::this_thread::get_id(); }
+    bool IsInMainThread() const { return std::this_thread::get_id() == MainThread; }
+
+    // Push the node to the queue. Can be called from any thread.
+    void Push(CoroHopNode* Node)
+    {
+        CoroHopNode* OldHead = Head.load(std::memory_order_relaxed);
+        do
+        {
+            Node->Next = OldHead;
+        }
+        while (Head.compare_exchange_weak(OldHead, Node, std::memory_order_release, std::memory_order_relaxed) == false);
+
+        if (OldHead == nullptr)
+        {
+            Head.notify_one();
+        }
+    }
+
+    // Block until something is pushed, then resume every pushed coroutine in the order they were pushed.
+    // Must be called only by the main thread, once per frame of the main loop.
+    void WaitAndDrain()
+    {
+        Head.wait(nullptr, std::memory_order_acquire);
+        CoroHopNode* List = Head.exchange(nullptr, std::memory_order_acquire);
+        CoroHopNode* Reversed = nullptr;
+        while (List)
+        {
+            CoroHopNode* Next = List->Next;
+            List->Next = Reversed;
+            Reversed = List;
+            List = Next;
+        }
+        while (Reversed)
+        {
+            // Read the next node before resuming, because the resumed coroutine destroys the awaiter which holds the node
+            CoroHopNode* Next = Reversed->Next;
+            Reversed->Handle.resume();
+            Reversed = Next;
+        }
+    }
+
+private:
+
+    std::thread::id MainThread;
+    std::atomic<CoroHopNode*> Head = nullptr;
+};
+
+// Pool of background threads. Waiting nodes form an intrusive list guarded by the mutex, so pushing doesn't allocate.
+class CoroBackgroundPool
+{
+public:
+
+    // Get the one and only background pool
+    static CoroBackgroundPool& Get()
+    {
+        static CoroBackgroundPool Pool(2);
+        return Pool;
+    }
+
+    // Push the node to the queue and wake one of the workers
+    void Push(CoroHopNode* Node)
+    {
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            Node->Next = nullptr;
+            if (Tail)
+            {
+                Tail->Next = Node;
+            }
+            else
+            {
+                Head = Node;
+            }
+            Tail = Node;
+        }
+        CondVar.notify_one();
+    }
+
+    bool IsInBackground() const { return bIsWorker; }
+
+    // Destructor - stop and join the worker threads
+    ~CoroBackgroundPool()
+    {
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            bStop = true;
+        }
+        CondVar.notify_all();
+        Workers.clear();
+    }
+
+private:
+
+    // Constructor - start the worker threads
+    explicit CoroBackgroundPool(unsigned NumThreads)
+    {
+        for (unsigned i = 0; i < NumThreads; i++)
+        {
+            Workers.emplace_back([this]() { WorkerLoop(); });
+        }
+    }
+
+    // Resume coroutines until the pool is stopped
+    void WorkerLoop()
+    {
+        bIsWorker = true;
+        for (;;)
+        {
+            std::coroutine_handle<> Handle;
+            {
+                std::unique_lock<std::mutex> Lock(Mutex);
+                CondVar.wait(Lock, [this]() { return Head != nullptr || bStop; });
+                if (Head == nullptr)
+                {
+                    return;
+                }
+
+                // Take the Handle under the lock, because the node can't be touched after the coroutine is resumed
+                Handle = Head->Handle;
+                Head = Head->Next;
+                if (Head == nullptr)
+                {
+                    Tail = nullptr;
+                }
+            }
+            Handle.resume();
+        }
+    }
+
+    static inline thread_local bool bIsWorker = false;
+
+    std::mutex Mutex;
+    std::condition_variable CondVar;
+    CoroHopNode* Head = nullptr;
+    CoroHopNode* Tail = nullptr;
+    bool bStop = false;
+    std::vector<std::jthread> Workers;
+};
+
+// Awaiter moving the coroutine to the background pool. It doesn't suspend if the coroutine is already there.
+struct ResumeOnBackgroundAwaiter : private CoroHopNode
+{
+    bool await_ready() const { return CoroBackgroundPool::Get().IsInBackground(); }
+
+    void await_suspend(std::coroutine_handle<> InHandle)
+    {
+        Handle = InHandle;
+        CoroBackgroundPool::Get().Push(this);
+    }
+
+    void await_resume() const noexcept {}
+};
+
+// Awaiter moving the coroutine to the main thread. It doesn't suspend if the coroutine is already there.
+struct ResumeOnMainThreadAwaiter : private CoroHopNode
+{
+    bool await_ready() const { return CoroMainThreadQueue::Get().IsInMainThread(); }
+
+    void await_suspend(std::coroutine_handle<> InHandle)
+    {
+        Handle = InHandle;
+        CoroMainThreadQueue::Get().Push(this);
+    }
+
+    void await_resume() const noexcept {}
+};
+
+// Use co_await ResumeOnBackground() and co_await ResumeOnMainThread() to continue the coroutine on the other thread
+ResumeOnBackgroundAwaiter ResumeOnBackground() { return {}; }
+ResumeOnMainThreadAwaiter ResumeOnMainThread() { return {}; }
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroPromise;
+};
+
+// Definition of the coroutine Promise
+struct CoroPromise
+{
+    // Called in order to construct the coroutine Handle
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+
+    // Do not suspend when the coroutine starts
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    // Do not suspend when the coroutine ends
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs
+    void unhandled_exception() {}
+};
+
+// Expensive computation which shouldn't stall the main thread
+int CountPrimes(int Limit)
+{
+    int Count = 0;
+    for (int i = 2; i <= Limit; i++)
+    {
+        bool bIsPrime = true;
+        for (int j = 2; j * j <= i; j++)
+        {
+            if (i % j == 0)
+            {
+                bIsPrime = false;
+                break;
+            }
+        }
+        Count += bIsPrime ? 1 : 0;
+    }
+    return Count;
+}
+
+// Coroutine which starts on the main thread, computes the result on the background thread
+// and goes back to the main thread to apply it
+CoroHandle CoroCountPrimes(int Limit, bool& bDone)
+{
+    std::cout << "Started on the main thread: " << CoroMainThreadQueue::Get().IsInMainThread() << "\n";
+
+    co_await ResumeOnBackground();
+    const int Count = CountPrimes(Limit);
+    const bool bComputedInBackground = CoroBackgroundPool::Get().IsInBackground();
+
+    co_await ResumeOnMainThread();
+    std::cout << "Computed in the background: " << bComputedInBackground << "\n";
+    std::cout << "Primes up to " << Limit << ": " << Count << "\n";
+    std::cout << "Applied on the main thread: " << CoroMainThreadQueue::Get().IsInMainThread() << "\n";
+    bDone = true;
+}
+
+// Main program
+int main()
+{
+    CoroMainThreadQueue& MainThreadQueue = CoroMainThreadQueue::Get();
+    MainThreadQueue.SetMainThread();
+
+    // bDone is touched only on the main thread, so it doesn't need to be atomic
+    bool bDone = false;
+    CoroCountPrimes(100000, bDone);
+
+    // The main loop. It sleeps until a coroutine comes back to the main thread.
+    while (bDone == false)
+    {
+        MainThreadQueue.WaitAndDrain();
+    }
+
+    return 0;
+}
+
+/**
+ The program should output:
+
+ Started on the main thread: 1
+ Computed in the background: 1
+ Primes up to 100000: 9592
+ Applied on the main thread: 1
+*/
@@ -0,0 +1,250 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutines which sleep for a specific amount of time without Unreal Engine.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Event loop which resumes sleeping coroutines when their deadlines pass. It keeps them as a min-heap of deadlines,
+// the same as the CoroTimerQueue from the 06_CoroUE5TimerQueue.cpp sample, and waits for the earliest one only,
+// so one thread can serve any amount of sleeping coroutines.
+class CoroTimerLoop
+{
+public:
+
+    using Clock = std::chrono::steady_clock;
+
+    // Awaiter used by SleepFor and SleepUntil
+    struct SleepAwaiter
+    {
+        CoroTimerLoop& Loop;
+        Clock::time_point Deadline;
+
+        // Ignore suspension if the deadline has already passed
+        bool await_ready() const { return Deadline <= Clock::now(); }
+        void await_suspend(std::coroutine_handle<> Handle) { Loop.Add(Deadline, Handle); }
+        void await_resume() const noexcept {}
+    };
+
+    // Use co_await Loop.SleepFor(Duration) or co_await Loop.SleepUntil(TimePoint) to suspend the coroutine
+    template<typename Rep, typename Period>
+    SleepAwaiter SleepFor(std::chrono::duration<Rep, Period> Duration)
+    {
+        return { *this, Clock::now() + std::chrono::duration_cast<Clock::duration>(Duration) };
+    }
+    SleepAwaiter SleepUntil(Clock::time_point Deadline) { return { *this, Deadline }; }
+
+    // The condition variable can wake up much later than asked, so the last part of the wait is done by spinning.
+    // Longer spin gives better accuracy, but it burns the CPU.
+    void SetSpinTime(std::chrono::microseconds InSpinTime) { SpinTime = InSpinTime; }
+
+    // Resume coroutines as their deadlines pass, until there are no sleeping coroutines left
+    void Run()
+    {
+        std::unique_lock<std::mutex> Lock(Mutex);
+        while (Timers.empty() == false)
+        {
+            // Sleep until the earliest deadline. Adding an earlier timer from another thread wakes the loop.
+            const Clock::time_point WakeTime = Timers.front().Deadline - SpinTime;
+            if (Clock::now() < WakeTime)
+            {
+                CondVar.wait_until(Lock, WakeTime);
+                continue;
+            }
+
+            // Spin until the earliest deadline really passes
+            const Clock::time_point Deadline = Timers.front().Deadline;
+            Lock.unlock();
+            while (Clock::now() < Deadline)
+            {
+                std::this_thread::yield();
+            }
+            Lock.lock();
+
+            // Take every expired timer at once and resume them without the lock, because they will add new timers
+            const Clock::time_point Now = Clock::now();
+            while (Timers.empty() == false && Timers.front().Deadline <= Now)
+            {
+                std::pop_heap(Timers.begin(), Timers.end(), FTimerPredicate());
+                Expired.push_back(Timers.back().Handle);
+                Timers.pop_back();
+            }
+            Lock.unlock();
+            for (const std::coroutine_handle<> Handle : Expired)
+            {
+                Handle.resume();
+            }
+            NumResumed += Expired.size();
+            Expired.clear();
+            Lock.lock();
+        }
+    }
+
+    // Amount of coroutines resumed by the loop
+    uint64_t GetNumResumed() const { return NumResumed; }
+
+private:
+
+    // Single sleeping coroutine and it's deadline
+    struct FTimer
+    {
+        Clock::time_point Deadline;
+
+        // Keeps the order of timers with the same deadline, so they are resumed in the order they were added
+        uint64_t Sequence;
+
+        std::coroutine_handle<> Handle;
+    };
+
+    // Orders the heap so the earliest deadline is always on top
+    struct FTimerPredicate
+    {
+        bool operator()(const FTimer& A, const FTimer& B) const
+        {
+            return A.Deadline > B.Deadline || (A.Deadline == B.Deadline && A.Sequence > B.Sequence);
+        }
+    };
+
+    // Add the sleeping coroutine. Can be called from any thread.
+    void Add(Clock::time_point Deadline, std::coroutine_handle<> Handle)
+    {
+        bool bIsEarliest = false;
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            Timers.push_back({ Deadline, NextSequence++, Handle });
+            std::push_heap(Timers.begin(), Timers.end(), FTimerPredicate());
+            bIsEarliest = Timers.front().Handle == Handle;
+        }
+
+        // Wake the loop only if it sleeps for the later deadline
+        if (bIsEarliest)
+        {
+            CondVar.notify_one();
+        }
+    }
+
+    std::mutex Mutex;
+    std::condition_variable CondVar;
+
+    // Sleeping coroutines kept as a min-heap of deadlines
+    std::vector<FTimer> Timers;
+
+    // Coroutines expired in the current iteration of the loop. It is reused, so it doesn't allocate after it has grown.
+    std::vector<std::coroutine_handle<>> Expired;
+
+    // Sequence number for the next added timer
+    uint64_t NextSequence = 0;
+
+    // Time of spinning before every deadline
+    std::chrono::microseconds SpinTime = std::chrono::microseconds(50);
+
+    // Amount of coroutines resumed by the loop
+    uint64_t NumResumed = 0;
+};
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroPromise;
+};
+
+// Definition of the coroutine Promise
+struct CoroPromise
+{
+    // Called in order to construct the coroutine Handle
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+
+    // Do not suspend when the coroutine starts
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    // Do not suspend when the coroutine ends
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs
+    void unhandled_exception() {}
+};
+
+// Statistics of the wake ups, touched only by the loop thread
+struct FWakeStats
+{
+    uint64_t NumWakeUps = 0;
+    uint64_t NumEarly = 0;
+    std::chrono::nanoseconds TotalLateness = {};
+};
+
+// Coroutine which sleeps a few times. Every sleep is checked against it's deadline.
+CoroHandle CoroSleeper(CoroTimerLoop& Loop, int Index, FWakeStats& Stats)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        const CoroTimerLoop::Clock::time_point Deadline = CoroTimerLoop::Clock::now() + std::chrono::milliseconds(1 + Index % 20);
+        co_await Loop.SleepUntil(Deadline);
+
+        const CoroTimerLoop::Clock::time_point Now = CoroTimerLoop::Clock::now();
+        Stats.NumWakeUps++;
+        if (Now < Deadline)
+        {
+            Stats.NumEarly++;
+        }
+        Stats.TotalLateness += Now - Deadline;
+    }
+}
+
+// Coroutine which counts down using SleepFor
+CoroHandle CoroCountdown(CoroTimerLoop& Loop)
+{
+    for (int i = 3; i > 0; i--)
+    {
+        std::cout << i << "...\n";
+        co_await Loop.SleepFor(std::chrono::milliseconds(100));
+    }
+    std::cout << "Go!\n";
+}
+
+// Main program
+int main()
+{
+    CoroTimerLoop Loop;
+    FWakeStats Stats;
+
+    CoroCountdown(Loop);
+    for (int i = 0; i < 20000; i++)
+    {
+        CoroSleeper(Loop, i, Stats);
+    }
+
+    Loop.Run();
+
+    std::cout << "Resumed: " << Loop.GetNumResumed() << "\n";
+    std::cout << "Woken early: " << Stats.NumEarly << "\n";
+    std::cout << "Average lateness: " << std::chrono::duration_cast<std::chrono::microseconds>(Stats.TotalLateness / Stats.NumWakeUps).count() << " us\n";
+
+    return 0;
+}
+
+/**
+ The program should output (the average lateness depends on the machine):
+
+ 3...
+ 2...
+ 1...
+ Go!
+ Resumed: 60003
+ Woken early: 0
+ Average lateness: 31 us
+*/
@@ -0,0 +1,312 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutines which are resumed in the order of their priorities.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+
+// Priority of the resumed coroutine
+enum class ECoroPriority : uint8_t
+{
+    Low,
+    Normal,
+    High
+};
+
+// Node of the ready queues. It is embedded inside the awaiter, so scheduling a coroutine doesn't allocate anything.
+struct CoroReadyNode
+{
+    // Next node in the queue
+    CoroReadyNode* Next = nullptr;
+
+    // Coroutine to resume when the node is popped from the queue
+    std::coroutine_handle<> Handle;
+};
+
+// Scheduler which resumes ready coroutines on one thread, the highest priority first. Every priority level has it's own
+// lock-free queue, the same as the CoroReadyQueue from the 10_CoroReadyQueue.cpp sample, so any thread can schedule a coroutine.
+// A level which has been passed over too many times is served once, so bulk work is never starved by a flood of urgent work.
+class CoroPriorityScheduler
+{
+public:
+
+    static constexpr std::size_t NumPriorities = 3;
+
+    // Awaiter which puts the coroutine into the ready queue of the given priority
+    class ScheduleAwaiter : private CoroReadyNode
+    {
+    public:
+
+        ScheduleAwaiter(CoroPriorityScheduler& InScheduler, ECoroPriority InPriority) : Scheduler(InScheduler), Priority(InPriority) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> InHandle)
+        {
+            Handle = InHandle;
+            Scheduler.Push(this, Priority);
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+
+        CoroPriorityScheduler& Scheduler;
+        ECoroPriority Priority;
+    };
+
+    // Use co_await Scheduler.Schedule(Priority) to continue the coroutine when the scheduler gets to it
+    ScheduleAwaiter Schedule(ECoroPriority Priority) { return ScheduleAwaiter(*this, Priority); }
+
+    // Amount of times a waiting level can be passed over before it is served in front of higher levels
+    void SetStarvationLimit(uint32_t InLimit) { StarvationLimit = InLimit; }
+
+    // Resume one ready coroutine. Returns false if there was nothing to resume. Must be called only by the owning thread.
+    bool RunOne()
+    {
+        for (FLevel& Level : Levels)
+        {
+            Level.Collect();
+        }
+
+        // Find the lowest starving level first, then the highest ready level
+        FLevel* Chosen = nullptr;
+        for (FLevel& Level : Levels)
+        {
+            if (Level.Pending && Level.NumSkipped >= StarvationLimit)
+            {
+                Chosen = &Level;
+                break;
+            }
+        }
+        for (std::size_t i = NumPriorities; Chosen == nullptr && i > 0; i--)
+        {
+            if (Levels[i - 1].Pending)
+            {
+                Chosen = &Levels[i - 1];
+            }
+        }
+        if (Chosen == nullptr)
+        {
+            return false;
+        }
+
+        // Every other waiting level has been passed over once more
+        for (FLevel& Level : Levels)
+        {
+            if (&Level != Chosen && Level.Pending)
+            {
+                Level.NumSkipped++;
+            }
+        }
+        Chosen->NumSkipped = 0;
+        Chosen->NumResumed++;
+        NumResumed++;
+
+        // Read the Handle before resuming, because the resumed coroutine destroys the awaiter which holds the node
+        CoroReadyNode* Node = Chosen->Pending;
+        Chosen->Pending = Node->Next;
+        if (Chosen->Pending == nullptr)
+        {
+            Chosen->PendingTail = nullptr;
+        }
+        Node->Handle.resume();
+        return true;
+    }
+
+    // Resume coroutines until there is nothing left to resume
+    void Run()
+    {
+        while (RunOne())
+        {
+        }
+    }
+
+    // Amount of coroutines resumed so far, in total and with the given priority
+    uint64_t GetNumResumed() const { return NumResumed; }
+    uint64_t GetNumResumed(ECoroPriority Priority) const { return Levels[static_cast<std::size_t>(Priority)].NumResumed; }
+
+private:
+
+    // Ready queue of a single priority level
+    struct FLevel
+    {
+        // Nodes pushed by any thread. The lastly pushed node is the head.
+        std::atomic<CoroReadyNode*> Incoming = nullptr;
+
+        // Nodes taken by the owning thread, in the order they were pushed
+        CoroReadyNode* Pending = nullptr;
+        CoroReadyNode* PendingTail = nullptr;
+
+        // Amount of times this level has been passed over while it had ready coroutines
+        uint32_t NumSkipped = 0;
+
+        uint64_t NumResumed = 0;
+
+        // Move every pushed node to the end of the pending list, keeping the order they were pushed
+        void Collect()
+        {
+            if (Incoming.load(std::memory_order_relaxed) == nullptr)
+            {
+                return;
+            }
+            CoroReadyNode* List = Incoming.exchange(nullptr, std::memory_order_acquire);
+            CoroReadyNode* Reversed = nullptr;
+            CoroReadyNode* ReversedTail = List;
+            while (List)
+            {
+                CoroReadyNode* Next = List->Next;
+                List->Next = Reversed;
+                Reversed = List;
+                List = Next;
+            }
+            if (PendingTail)
+            {
+                PendingTail->Next = Reversed;
+            }
+            else
+            {
+                Pending = Reversed;
+            }
+            PendingTail = ReversedTail;
+        }
+    };
+
+    // Push the node to the queue of the given priority. Can be called from any thread.
+    void Push(CoroReadyNode* Node, ECoroPriority Priority)
+    {
+        std::atomic<CoroReadyNode*>& Incoming = Levels[static_cast<std::size_t>(Priority)].Incoming;
+        CoroReadyNode* OldHead = Incoming.load(std::memory_order_relaxed);
+        do
+        {
+            Node->Next = OldHead;
+        }
+        while (Incoming.compare_exchange_weak(OldHead, Node, std::memory_order_release, std::memory_order_relaxed) == false);
+    }
+
+    std::array<FLevel, NumPriorities> Levels;
+    uint32_t StarvationLimit = 16;
+    uint64_t NumResumed = 0;
+};
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroPromise;
+};
+
+// Definition of the coroutine Promise
+struct CoroPromise
+{
+    // Called in order to construct the coroutine Handle
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+
+    // Do not suspend when the coroutine starts
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    // Do not suspend when the coroutine ends
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs
+    void unhandled_exception() {}
+};
+
+// Priorities used by the sample. Running it without priorities gives every coroutine the same one.
+struct FSamplePriorities
+{
+    ECoroPriority Input;
+    ECoroPriority Bulk;
+};
+
+// The biggest amount of resumes the input coroutine had to wait for
+uint64_t MaxInputLatency = 0;
+
+// Input handling coroutine. It is scheduled when the input arrives and measures how long it waits for the scheduler.
+CoroHandle CoroHandleInput(CoroPriorityScheduler& Scheduler, ECoroPriority Priority)
+{
+    const uint64_t ArrivedAt = Scheduler.GetNumResumed();
+    co_await Scheduler.Schedule(Priority);
+    const uint64_t Latency = Scheduler.GetNumResumed() - ArrivedAt;
+    MaxInputLatency = Latency > MaxInputLatency ? Latency : MaxInputLatency;
+}
+
+// Bulk background work, like the fade of something far away. It gives the scheduler back after every step.
+// Every 50th resume of the scheduler an input arrives.
+CoroHandle CoroBulkWork(CoroPriorityScheduler& Scheduler, FSamplePriorities Priorities, int NumSteps)
+{
+    for (int i = 0; i < NumSteps; i++)
+    {
+        co_await Scheduler.Schedule(Priorities.Bulk);
+        if (Scheduler.GetNumResumed() % 50 == 0)
+        {
+            CoroHandleInput(Scheduler, Priorities.Input);
+        }
+    }
+}
+
+// Run 200 bulk coroutines and print the worst latency of the input
+void RunBulkWork(const char* Name, FSamplePriorities Priorities)
+{
+    CoroPriorityScheduler Scheduler;
+    MaxInputLatency = 0;
+    for (int i = 0; i < 200; i++)
+    {
+        CoroBulkWork(Scheduler, Priorities, 10);
+    }
+    Scheduler.Run();
+    std::cout << Name << ": " << Scheduler.GetNumResumed() << " resumes, max input latency " << MaxInputLatency << " resumes\n";
+}
+
+// Urgent coroutine which reschedules itself over and over
+CoroHandle CoroFlood(CoroPriorityScheduler& Scheduler, int NumSteps)
+{
+    for (int i = 0; i < NumSteps; i++)
+    {
+        co_await Scheduler.Schedule(ECoroPriority::High);
+    }
+}
+
+// Main program
+int main()
+{
+    RunBulkWork("Without priorities", { ECoroPriority::Normal, ECoroPriority::Normal });
+    RunBulkWork("With priorities", { ECoroPriority::High, ECoroPriority::Low });
+
+    // Four urgent coroutines never let the queue of the high priority become empty,
+    // but the bulk work still gets one resume after every 16 urgent ones
+    CoroPriorityScheduler Scheduler;
+    for (int i = 0; i < 4; i++)
+    {
+        CoroFlood(Scheduler, 400);
+    }
+    CoroBulkWork(Scheduler, { ECoroPriority::High, ECoroPriority::Low }, 1000);
+    for (int i = 0; i < 1700; i++)
+    {
+        Scheduler.RunOne();
+    }
+    std::cout << "During the flood: " << Scheduler.GetNumResumed(ECoroPriority::High) << " high, "
+        << Scheduler.GetNumResumed(ECoroPriority::Low) << " low\n";
+    Scheduler.Run();
+
+    return 0;
+}
+
+/**
+ The program should output:
+
+ Without priorities: 2039 resumes, max input latency 204 resumes
+ With priorities: 2040 resumes, max input latency 1 resumes
+ During the flood: 1600 high, 100 low
+*/
@@ -0,0 +1,360 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutine generator which is reused for many sequences instead of being created again.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <utility>
+
+// Amount of allocated coroutine frames, so the cost of both Generators can be compared
+static uint64_t NumFrames = 0;
+
+// Regular Generator, the same as in the 03_CoroGenerators.cpp sample
+template<typename T>
+struct CoroGenerator
+{
+    struct CoroPromise;
+    using promise_type = CoroPromise;
+    using CoroHandle = std::coroutine_handle<CoroPromise>;
+
+    struct CoroPromise
+    {
+        const T* Value = nullptr;
+
+        static void* operator new(std::size_t Size)
+        {
+            NumFrames++;
+            return ::operator new(Size);
+        }
+        static void operator delete(void* Ptr) { ::operator delete(Ptr); }
+
+        CoroGenerator get_return_object() { return CoroGenerator(CoroHandle::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() {}
+
+        std::suspend_always yield_value(const T& from)
+        {
+            Value = std::addressof(from);
+            return {};
+        }
+    };
+
+    class Iterator
+    {
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+        explicit Iterator(CoroHandle InHandle) : Handle(InHandle) {}
+
+        const T& operator*() const { return *Handle.promise().Value; }
+        Iterator& operator++()
+        {
+            Handle.resume();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+        bool operator==(std::default_sentinel_t) const { return Handle.done(); }
+
+    private:
+        CoroHandle Handle;
+    };
+
+    Iterator begin()
+    {
+        Handle.resume();
+        return Iterator(Handle);
+    }
+    std::default_sentinel_t end() { return {}; }
+
+    explicit CoroGenerator(CoroHandle InHandle) : Handle(InHandle) {}
+    CoroGenerator(const CoroGenerator&) = delete;
+    CoroGenerator& operator=(const CoroGenerator&) = delete;
+    CoroGenerator(CoroGenerator&& Other) noexcept : Handle(std::exchange(Other.Handle, {})) {}
+    ~CoroGenerator()
+    {
+        if (Handle)
+        {
+            Handle.destroy();
+        }
+    }
+
+private:
+    CoroHandle Handle;
+};
+
+// Use co_await CoroNextArguments{} inside the reusable Generator to finish the current sequence and wait for the arguments of the next one
+struct CoroNextArguments {};
+
+// Definition of the reusable Generator. The coroutine which has finished can't be started again, so the reusable Generator
+// never finishes. Instead it loops forever: it waits for the arguments, yields the sequence for them and waits again.
+// Every next sequence is started with Reset(Arguments), so the frame is allocated and constructed only once.
+template<typename T, typename Args>
+struct CoroReusableGenerator
+{
+    // Forward declaration of the Promise so it can be used for a Handle definition
+    struct CoroPromise;
+
+    // Tell the Generator to use our Promise
+    using promise_type = CoroPromise;
+
+    // Convinient alias for the coroutine Handle type which uses declared Promise
+    using CoroHandle = std::coroutine_handle<CoroPromise>;
+
+    // Definition of the Generator Promise
+    struct CoroPromise
+    {
+        // Pointer to the lastly yielded value
+        const T* Value = nullptr;
+
+        // Arguments of the next sequence, valid when bArmed is set
+        Args Arguments = {};
+        bool bArmed = false;
+
+        // Set when the current sequence has finished and the Generator waits for the next arguments
+        bool bSequenceDone = true;
+
+        // Awaiter which finishes the current sequence and gives the arguments of the next one
+        struct NextArgumentsAwaiter
+        {
+            CoroPromise& Promise;
+
+            // Continue right away if the arguments have been already given
+            bool await_ready() noexcept { return Promise.bArmed; }
+
+            // Suspend back to the consumer, who sees the end of the sequence
+            void await_suspend(std::coroutine_handle<>) noexcept { Promise.bSequenceDone = true; }
+
+            // Take the arguments, so the next sequence needs the next Reset
+            Args await_resume() noexcept
+            {
+                Promise.bArmed = false;
+                return std::move(Promise.Arguments);
+            }
+        };
+
+        static void* operator new(std::size_t Size)
+        {
+            NumFrames++;
+            return ::operator new(Size);
+        }
+        static void operator delete(void* Ptr) { ::operator delete(Ptr); }
+
+        // Called in order to construct the Generator
+        CoroReusableGenerator get_return_object() { return CoroReusableGenerator(CoroHandle::from_promise(*this)); }
+
+        // Suspend the Generator at the beginning, it starts when the first sequence is iterated
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // The Generator never finishes by itself, but it suspends at the end anyway, so it is destroyed by the owner
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        // Called when co_return is used
+        void return_void() {}
+
+        // Called when exception occurs
+        void unhandled_exception() {}
+
+        // Called when co_yield is used
+        std::suspend_always yield_value(const T& from)
+        {
+            Value = std::addressof(from);
+            return {};
+        }
+
+        // Called when co_await CoroNextArguments is used
+        NextArgumentsAwaiter await_transform(CoroNextArguments) noexcept { return { *this }; }
+    };
+
+    // Iterator of the current sequence
+    class Iterator
+    {
+    public:
+
+        // Types required by the std::input_iterator concept
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        // Iterators must be default constructible in order to be used with std::ranges
+        Iterator() = default;
+
+        // Constructor - remember the Handle of the Generator
+        explicit Iterator(CoroHandle InHandle) : Handle(InHandle) {}
+
+        // Get the lastly yielded value
+        const T& operator*() const { return *Handle.promise().Value; }
+
+        // Resume the Generator to get the next value
+        Iterator& operator++()
+        {
+            Handle.resume();
+            return *this;
+        }
+
+        // Post increment doesn't have to return anything for input iterators
+        void operator++(int) { ++*this; }
+
+        // Iterator reached the end when the sequence has finished, not the coroutine
+        bool operator==(std::default_sentinel_t) const { return Handle.promise().bSequenceDone || Handle.done(); }
+
+    private:
+
+        // Handle of the iterated Generator
+        CoroHandle Handle;
+    };
+
+    // Give the arguments of the next sequence
+    void Reset(Args InArguments)
+    {
+        CoroPromise& Promise = Handle.promise();
+
+        // The previous sequence has been started, but left before it's end, like with a break out of the loop.
+        // Run it to the end first, so the rest of it doesn't join the next sequence. It costs one resume per every value left.
+        // If the previous sequence hasn't been started at all, it's arguments are simply replaced.
+        if (Promise.bSequenceDone == false && Promise.bArmed == false)
+        {
+            while (Promise.bSequenceDone == false && Handle.done() == false)
+            {
+                Handle.resume();
+            }
+        }
+
+        Promise.Arguments = std::move(InArguments);
+        Promise.bArmed = true;
+        Promise.bSequenceDone = false;
+    }
+
+    // Start the sequence given by the last Reset and get the Iterator to it's first value.
+    // Without the Reset the sequence is empty and the frame is not resumed, so it keeps waiting for the arguments.
+    Iterator begin()
+    {
+        if (Handle.promise().bSequenceDone == false)
+        {
+            Handle.resume();
+        }
+        return Iterator(Handle);
+    }
+
+    // The end of the sequence is represented by the default sentinel
+    std::default_sentinel_t end() { return {}; }
+
+    // Constructor - save the coroutine Handle given during the get_return_object call in the Promise
+    explicit CoroReusableGenerator(CoroHandle InHandle) : Handle(InHandle) {}
+
+    // Generator owns the coroutine Handle, so it can be only moved
+    CoroReusableGenerator(const CoroReusableGenerator&) = delete;
+    CoroReusableGenerator& operator=(const CoroReusableGenerator&) = delete;
+    CoroReusableGenerator(CoroReusableGenerator&& Other) noexcept : Handle(std::exchange(Other.Handle, {})) {}
+
+    // Destructor - explicitly destroy the coroutine Handle. It can be destroyed while it waits for the next arguments.
+    ~CoroReusableGenerator()
+    {
+        if (Handle)
+        {
+            Handle.destroy();
+        }
+    }
+
+private:
+
+    // Stores the coroutine Handle used within this Generator
+    CoroHandle Handle;
+};
+
+// Regular Generator of the Fibonacci sequence, created again for every sequence
+CoroGenerator<int> FibonacciGenerator(const int Amount)
+{
+    int A = 0;
+    int B = 1;
+    for (int i = 0; i < Amount; i++)
+    {
+        co_yield A;
+        const int Next = A + B;
+        A = B;
+        B = Next;
+    }
+}
+
+// Reusable Generator of the Fibonacci sequence. Local variables of the sequence are declared inside the loop,
+// so they start from their initial values for every sequence.
+CoroReusableGenerator<int, int> ReusableFibonacciGenerator()
+{
+    for (;;)
+    {
+        const int Amount = co_await CoroNextArguments{};
+        int A = 0;
+        int B = 1;
+        for (int i = 0; i < Amount; i++)
+        {
+            co_yield A;
+            const int Next = A + B;
+            A = B;
+            B = Next;
+        }
+    }
+}
+
+// Main program
+int main()
+{
+    constexpr int NumSequences = 100000;
+
+    NumFrames = 0;
+    int64_t Sum = 0;
+    for (int i = 0; i < NumSequences; i++)
+    {
+        for (const int Value : FibonacciGenerator(i % 20))
+        {
+            Sum += Value;
+        }
+    }
+    std::cout << "Regular: sum " << Sum << ", " << NumFrames << " frames\n";
+
+    NumFrames = 0;
+    Sum = 0;
+    CoroReusableGenerator<int, int> Fibonacci = ReusableFibonacciGenerator();
+    for (int i = 0; i < NumSequences; i++)
+    {
+        Fibonacci.Reset(i % 20);
+        for (const int Value : Fibonacci)
+        {
+            Sum += Value;
+        }
+    }
+    std::cout << "Reusable: sum " << Sum << ", " << NumFrames << " frames\n";
+
+    // Leave the sequence early. The next Reset runs the rest of it to the end, so it doesn't join the next sequence.
+    Fibonacci.Reset(20);
+    for (const int Value : Fibonacci)
+    {
+        if (Value > 10)
+        {
+            break;
+        }
+    }
+    Fibonacci.Reset(5);
+    std::cout << "After break:";
+    for (const int Value : Fibonacci)
+    {
+        std::cout << " " << Value;
+    }
+    std::cout << "\n";
+
+    return 0;
+}
+
+/**
+ The program should output:
+
+ Regular: sum 88450000, 100000 frames
+ Reusable: sum 88450000, 1 frames
+ After break: 0 1 1 2 3
+*/
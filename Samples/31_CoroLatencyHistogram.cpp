@@ -0,0 +1,370 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutines which measure how late they are resumed, using latency histograms.
+// The measured latencies depend on the machine.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Histogram of latencies in nanoseconds, in the style of the HDR histogram. Every power of two range of values
+// is split into 16 linear sub-buckets, so any value is stored with the error smaller than 6.25%, from nanoseconds
+// to hours, in the fixed amount of memory. Recording a value is a few integer operations and it never allocates.
+class CoroLatencyHistogram
+{
+public:
+
+    // Record a single latency
+    void Record(uint64_t Value)
+    {
+        Counts[IndexOf(Value)]++;
+        Count++;
+        Sum += Value;
+        Max = std::max(Max, Value);
+    }
+
+    // Get the value which is bigger than the given percent of all recorded values
+    uint64_t ValueAtPercentile(double Percentile) const
+    {
+        const uint64_t Target = std::max<uint64_t>(1, static_cast<uint64_t>(Percentile / 100.0 * static_cast<double>(Count) + 0.5));
+        uint64_t Seen = 0;
+        for (std::size_t i = 0; i < NumCounts; i++)
+        {
+            Seen += Counts[i];
+            if (Seen >= Target)
+            {
+                return std::min(HighestOf(i), Max);
+            }
+        }
+        return Max;
+    }
+
+    uint64_t GetCount() const { return Count; }
+    uint64_t GetMax() const { return Max; }
+    uint64_t GetMean() const { return Count > 0 ? Sum / Count : 0; }
+
+private:
+
+    static constexpr unsigned SubBucketBits = 4;
+    static constexpr uint64_t NumSubBuckets = 1 << SubBucketBits;
+    static constexpr std::size_t NumCounts = (64 - SubBucketBits + 1) * NumSubBuckets;
+
+    // Values smaller than the amount of sub-buckets are stored exactly, bigger ones by their highest bits
+    static std::size_t IndexOf(uint64_t Value)
+    {
+        if (Value < NumSubBuckets)
+        {
+            return static_cast<std::size_t>(Value);
+        }
+        const unsigned Shift = static_cast<unsigned>(std::bit_width(Value)) - 1 - SubBucketBits;
+        return (Shift + 1) * NumSubBuckets + ((Value >> Shift) & (NumSubBuckets - 1));
+    }
+
+    // The biggest value which is stored in the given counter
+    static uint64_t HighestOf(std::size_t Index)
+    {
+        if (Index < NumSubBuckets)
+        {
+            return Index;
+        }
+        const unsigned Shift = static_cast<unsigned>(Index / NumSubBuckets) - 1;
+        const uint64_t Lowest = (NumSubBuckets + Index % NumSubBuckets) << Shift;
+        return Lowest + (uint64_t(1) << Shift) - 1;
+    }
+
+    std::array<uint64_t, NumCounts> Counts = {};
+    uint64_t Count = 0;
+    uint64_t Sum = 0;
+    uint64_t Max = 0;
+};
+
+// Latencies of a single awaitable type
+struct FCoroLatencyStats
+{
+    const char* Name;
+
+    // Time between the deadline the coroutine asked for and the moment it has been resumed
+    CoroLatencyHistogram Overshoot;
+
+    // Time the coroutine has waited in the ready queue, after it could have been resumed
+    CoroLatencyHistogram QueueDelay;
+};
+
+// Registry of the latencies of every awaitable type
+class CoroLatencyRegistry
+{
+public:
+
+    // Get the one and only registry
+    static CoroLatencyRegistry& Get()
+    {
+        static CoroLatencyRegistry Registry;
+        return Registry;
+    }
+
+    // Get the latencies of the given awaitable type. It is looked up only once per type, so recording costs nothing more.
+    template<typename Awaitable>
+    static FCoroLatencyStats& For()
+    {
+        static FCoroLatencyStats& Stats = Get().Add(Awaitable::StatName);
+        return Stats;
+    }
+
+    // Latencies of every awaitable type which has been used so far
+    const std::vector<FCoroLatencyStats*>& GetAll() const { return All; }
+
+    ~CoroLatencyRegistry()
+    {
+        for (FCoroLatencyStats* Stats : All)
+        {
+            delete Stats;
+        }
+    }
+
+private:
+
+    FCoroLatencyStats& Add(const char* Name)
+    {
+        All.push_back(new FCoroLatencyStats{ Name, {}, {} });
+        return *All.back();
+    }
+
+    std::vector<FCoroLatencyStats*> All;
+};
+
+// Event loop which ticks with the fixed frame time, like the game loop. Coroutines which sleep are resumed
+// in the first frame after their deadline, so they are always late, by up to the whole frame.
+// The loop measures how late every coroutine is and how long it waits in the ready queue.
+class CoroFrameLoop
+{
+public:
+
+    using Clock = std::chrono::steady_clock;
+
+    // Awaiter which sleeps for the given amount of time
+    struct SleepAwaiter
+    {
+        static constexpr const char* StatName = "SleepAwaiter";
+
+        CoroFrameLoop& Loop;
+        Clock::time_point Deadline;
+
+        bool await_ready() const { return false; }
+        void await_suspend(std::coroutine_handle<> Handle) { Loop.AddTimer({ Deadline, Loop.NextSequence++, Handle, &CoroLatencyRegistry::For<SleepAwaiter>() }); }
+        void await_resume() const noexcept {}
+    };
+
+    // Awaiter which continues the coroutine in the next frame. It has no deadline, so only it's queue delay is measured.
+    struct NextFrameAwaiter
+    {
+        static constexpr const char* StatName = "NextFrameAwaiter";
+
+        CoroFrameLoop& Loop;
+
+        bool await_ready() const { return false; }
+        void await_suspend(std::coroutine_handle<> Handle) { Loop.Next.push_back({ Handle, {}, {}, &CoroLatencyRegistry::For<NextFrameAwaiter>() }); }
+        void await_resume() const noexcept {}
+    };
+
+    explicit CoroFrameLoop(Clock::duration InFrameTime) : FrameTime(InFrameTime) {}
+
+    template<typename Rep, typename Period>
+    SleepAwaiter SleepFor(std::chrono::duration<Rep, Period> Duration) { return { *this, Clock::now() + Duration }; }
+    NextFrameAwaiter NextFrame() { return { *this }; }
+
+    // Run frames until there is nothing left to resume
+    void Run()
+    {
+        Clock::time_point FrameStart = Clock::now();
+        while (Timers.empty() == false || Next.empty() == false)
+        {
+            FrameStart += FrameTime;
+            std::this_thread::sleep_until(FrameStart);
+            Tick();
+        }
+    }
+
+private:
+
+    // Coroutine which can be resumed
+    struct FReady
+    {
+        std::coroutine_handle<> Handle;
+
+        // Moment the coroutine has been put into the ready queue, at the start of the frame which resumes it
+        Clock::time_point EnqueuedAt;
+
+        // Deadline of the sleeping coroutine, empty for other ones
+        Clock::time_point Deadline;
+
+        FCoroLatencyStats* Stats;
+    };
+
+    // Single sleeping coroutine
+    struct FTimer
+    {
+        Clock::time_point Deadline;
+        uint64_t Sequence;
+        std::coroutine_handle<> Handle;
+        FCoroLatencyStats* Stats;
+    };
+
+    // Orders the heap so the earliest deadline is always on top
+    struct FTimerPredicate
+    {
+        bool operator()(const FTimer& A, const FTimer& B) const
+        {
+            return A.Deadline > B.Deadline || (A.Deadline == B.Deadline && A.Sequence > B.Sequence);
+        }
+    };
+
+    void AddTimer(const FTimer& Timer)
+    {
+        Timers.push_back(Timer);
+        std::push_heap(Timers.begin(), Timers.end(), FTimerPredicate());
+    }
+
+    // Move every expired coroutine to the ready queue and resume the whole queue
+    void Tick()
+    {
+        // Coroutines waiting for this frame enter the ready queue now, not when they have been suspended
+        std::swap(Ready, Next);
+        const Clock::time_point Now = Clock::now();
+        for (FReady& Entry : Ready)
+        {
+            Entry.EnqueuedAt = Now;
+        }
+        while (Timers.empty() == false && Timers.front().Deadline <= Now)
+        {
+            std::pop_heap(Timers.begin(), Timers.end(), FTimerPredicate());
+            const FTimer& Timer = Timers.back();
+            Ready.push_back({ Timer.Handle, Now, Timer.Deadline, Timer.Stats });
+            Timers.pop_back();
+        }
+
+        for (const FReady& Entry : Ready)
+        {
+            const Clock::time_point ResumeTime = Clock::now();
+            Entry.Stats->QueueDelay.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(ResumeTime - Entry.EnqueuedAt).count());
+            if (Entry.Deadline != Clock::time_point())
+            {
+                Entry.Stats->Overshoot.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(ResumeTime - Entry.Deadline).count());
+            }
+            Entry.Handle.resume();
+        }
+        Ready.clear();
+    }
+
+    Clock::duration FrameTime;
+
+    // Sleeping coroutines kept as a min-heap of deadlines
+    std::vector<FTimer> Timers;
+
+    // Coroutines resumed in the current frame and in the next one. Both are reused, so they don't allocate after they have grown.
+    std::vector<FReady> Ready;
+    std::vector<FReady> Next;
+
+    uint64_t NextSequence = 0;
+};
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroPromise;
+};
+
+// Definition of the coroutine Promise
+struct CoroPromise
+{
+    // Called in order to construct the coroutine Handle
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+
+    // Do not suspend when the coroutine starts
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    // Do not suspend when the coroutine ends
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs
+    void unhandled_exception() {}
+};
+
+// Coroutine which sleeps for the time which doesn't match the frame time
+CoroHandle CoroSleeper(CoroFrameLoop& Loop, int Index)
+{
+    for (int i = 0; i < 20; i++)
+    {
+        co_await Loop.SleepFor(std::chrono::microseconds(300 + 700 * (Index % 7)));
+    }
+}
+
+// Coroutine which does a bit of work every frame
+CoroHandle CoroEveryFrame(CoroFrameLoop& Loop)
+{
+    for (int i = 0; i < 100; i++)
+    {
+        co_await Loop.NextFrame();
+    }
+}
+
+// Print the histogram in microseconds
+void PrintHistogram(const char* Name, const char* Kind, const CoroLatencyHistogram& Histogram)
+{
+    if (Histogram.GetCount() == 0)
+    {
+        return;
+    }
+    std::cout << Name << " " << Kind << ": " << Histogram.GetCount() << " samples"
+        << ", p50 " << Histogram.ValueAtPercentile(50.0) / 1000 << " us"
+        << ", p90 " << Histogram.ValueAtPercentile(90.0) / 1000 << " us"
+        << ", p99 " << Histogram.ValueAtPercentile(99.0) / 1000 << " us"
+        << ", max " << Histogram.GetMax() / 1000 << " us\n";
+}
+
+// Main program
+int main()
+{
+    // Frames of 1 millisecond
+    CoroFrameLoop Loop(std::chrono::milliseconds(1));
+
+    for (int i = 0; i < 200; i++)
+    {
+        CoroSleeper(Loop, i);
+    }
+    for (int i = 0; i < 50; i++)
+    {
+        CoroEveryFrame(Loop);
+    }
+    Loop.Run();
+
+    for (const FCoroLatencyStats* Stats : CoroLatencyRegistry::Get().GetAll())
+    {
+        PrintHistogram(Stats->Name, "overshoot", Stats->Overshoot);
+        PrintHistogram(Stats->Name, "queue delay", Stats->QueueDelay);
+    }
+
+    return 0;
+}
+
+/**
+ The program should output something like:
+
+ SleepAwaiter overshoot: 4000 samples, p50 622 us, p90 983 us, p99 1015 us, max 1016 us
+ SleepAwaiter queue delay: 4000 samples, p50 13 us, p90 25 us, p99 36 us, max 37 us
+ NextFrameAwaiter queue delay: 5000 samples, p50 4 us, p90 10 us, p99 18 us, max 28 us
+*/
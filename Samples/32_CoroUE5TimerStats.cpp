@@ -0,0 +1,260 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of coroutines in Unreal Engine 5 which measure how late they are resumed and show it with "stat Coro".
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <coroutine>
+#include "Containers/Ticker.h"
+#include "HAL/PlatformTime.h"
+#include "Kismet/GameplayStatics.h"
+#include "Stats/Stats.h"
+
+// Stats shown in game with the "stat Coro" console command
+DECLARE_STATS_GROUP(TEXT("Coro"), STATGROUP_Coro, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Timers resumed"), STAT_CoroTimersResumed, STATGROUP_Coro);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Overshoot p50 (ms)"), STAT_CoroOvershootP50, STATGROUP_Coro);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Overshoot p99 (ms)"), STAT_CoroOvershootP99, STATGROUP_Coro);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Overshoot max (ms)"), STAT_CoroOvershootMax, STATGROUP_Coro);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Queue delay p99 (ms)"), STAT_CoroQueueDelayP99, STATGROUP_Coro);
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroPromise;
+};
+
+// Definition of the coroutine Promise
+struct CoroPromise
+{
+    // Called in order to construct the coroutine Handle
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+
+    // Do not suspend when the coroutine starts
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    // Do not suspend when the coroutine ends
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs
+    void unhandled_exception() {}
+};
+
+// Histogram of latencies in microseconds, the same as the CoroLatencyHistogram from the 31_CoroLatencyHistogram.cpp sample.
+// Every power of two range of values is split into 16 linear sub-buckets, so any value is stored with the error smaller than 6.25%.
+class FCoroLatencyHistogram
+{
+public:
+
+    // Record a single latency
+    void Record(uint64 Value)
+    {
+        Counts[IndexOf(Value)]++;
+        Count++;
+        Max = FMath::Max(Max, Value);
+    }
+
+    // Get the value which is bigger than the given percent of all recorded values
+    uint64 ValueAtPercentile(double Percentile) const
+    {
+        const uint64 Target = FMath::Max<uint64>(1, (uint64)(Percentile / 100.0 * (double)Count + 0.5));
+        uint64 Seen = 0;
+        for (int32 i = 0; i < NumCounts; i++)
+        {
+            Seen += Counts[i];
+            if (Seen >= Target)
+            {
+                return FMath::Min(HighestOf(i), Max);
+            }
+        }
+        return Max;
+    }
+
+    uint64 GetCount() const { return Count; }
+    uint64 GetMax() const { return Max; }
+
+private:
+
+    static constexpr uint32 SubBucketBits = 4;
+    static constexpr uint64 NumSubBuckets = 1 << SubBucketBits;
+    static constexpr int32 NumCounts = (64 - SubBucketBits + 1) * NumSubBuckets;
+
+    static int32 IndexOf(uint64 Value)
+    {
+        if (Value < NumSubBuckets)
+        {
+            return (int32)Value;
+        }
+        const uint32 Shift = 63 - FMath::CountLeadingZeros64(Value) - SubBucketBits;
+        return (int32)((Shift + 1) * NumSubBuckets + ((Value >> Shift) & (NumSubBuckets - 1)));
+    }
+
+    static uint64 HighestOf(int32 Index)
+    {
+        if (Index < NumSubBuckets)
+        {
+            return Index;
+        }
+        const uint32 Shift = (uint32)(Index / NumSubBuckets) - 1;
+        const uint64 Lowest = (NumSubBuckets + Index % NumSubBuckets) << Shift;
+        return Lowest + (uint64(1) << Shift) - 1;
+    }
+
+    uint64 Counts[NumCounts] = {};
+    uint64 Count = 0;
+    uint64 Max = 0;
+};
+
+// Queue of all suspended coroutines waiting for a specific time, the same as the CoroTimerQueue from the 06_CoroUE5TimerQueue.cpp sample.
+// The queue is ticked once per frame, so every coroutine is resumed in the first frame after it's deadline, up to the whole frame late.
+// The queue measures how late every coroutine is, and how long it waits behind the other coroutines resumed in the same frame.
+class CoroTimerQueue
+{
+public:
+
+    // Get the one and only timer queue
+    static CoroTimerQueue& Get()
+    {
+        static CoroTimerQueue Queue;
+        return Queue;
+    }
+
+    // Suspend given coroutine Handle until the given amount of time passes
+    void Add(float Time, std::coroutine_handle<> Handle)
+    {
+        // Start the Unreal ticker with the first waiting coroutine
+        if (TickerHandle.IsValid() == false)
+        {
+            TickerHandle = FTSTicker::GetCoreTicker().AddTicker(TEXT("CoroTimerQueue"), 0.f, [this](float DeltaTime) -> bool
+            {
+                Tick(DeltaTime);
+                return true;
+            });
+        }
+
+        Timers.HeapPush({ CurrentTime + Time, NextSequence++, Handle }, FTimerPredicate());
+    }
+
+    // Time between the deadline and the frame which has resumed the coroutine, in microseconds
+    const FCoroLatencyHistogram& GetOvershoot() const { return Overshoot; }
+
+    // Time between the start of the resuming and the resume of the coroutine, in microseconds
+    const FCoroLatencyHistogram& GetQueueDelay() const { return QueueDelay; }
+
+private:
+
+    // Single suspended coroutine and the time it should be resumed at
+    struct FTimer
+    {
+        double Deadline;
+
+        // Keeps the order of timers with the same deadline, so they are resumed in the order they were added
+        uint64 Sequence;
+
+        std::coroutine_handle<> Handle;
+    };
+
+    // Orders the heap so the earliest deadline is always on top
+    struct FTimerPredicate
+    {
+        bool operator()(const FTimer& A, const FTimer& B) const
+        {
+            return A.Deadline < B.Deadline || (A.Deadline == B.Deadline && A.Sequence < B.Sequence);
+        }
+    };
+
+    // Called once per frame by the Unreal ticker
+    void Tick(float DeltaTime)
+    {
+        CurrentTime += DeltaTime;
+
+        const double StartTime = FPlatformTime::Seconds();
+        uint32 NumResumed = 0;
+        while (Timers.Num() > 0 && Timers.HeapTop().Deadline <= CurrentTime)
+        {
+            FTimer Timer;
+            Timers.HeapPop(Timer, FTimerPredicate());
+            Overshoot.Record((uint64)((CurrentTime - Timer.Deadline) * 1000000.0));
+            QueueDelay.Record((uint64)((FPlatformTime::Seconds() - StartTime) * 1000000.0));
+            Timer.Handle.resume();
+            NumResumed++;
+        }
+
+        // Show the latencies since the start with the "stat Coro"
+        SET_DWORD_STAT(STAT_CoroTimersResumed, NumResumed);
+        SET_FLOAT_STAT(STAT_CoroOvershootP50, Overshoot.ValueAtPercentile(50.0) * .001f);
+        SET_FLOAT_STAT(STAT_CoroOvershootP99, Overshoot.ValueAtPercentile(99.0) * .001f);
+        SET_FLOAT_STAT(STAT_CoroOvershootMax, Overshoot.GetMax() * .001f);
+        SET_FLOAT_STAT(STAT_CoroQueueDelayP99, QueueDelay.ValueAtPercentile(99.0) * .001f);
+    }
+
+    // Time accumulated from all ticks
+    double CurrentTime = 0.0;
+
+    // Sequence number for the next added timer
+    uint64 NextSequence = 0;
+
+    // All waiting coroutines kept as a min-heap
+    TArray<FTimer> Timers;
+
+    // Latencies of all resumed coroutines
+    FCoroLatencyHistogram Overshoot;
+    FCoroLatencyHistogram QueueDelay;
+
+    // Unreal ticker handle
+    FTSTicker::FDelegateHandle TickerHandle;
+};
+
+// Definition of the coroutine Task used for suspending a specific amount of time
+class WaitSecondsTask
+{
+private:
+
+    // Time to wait before resume
+    float Time;
+
+public:
+
+    // Task constructor which stores the amount of time to being suspended
+    WaitSecondsTask(float InTime) : Time(InTime) {}
+
+    // Called when the coroutine has been resumed
+    void await_resume() {}
+
+    // Ignore suspension if the given time is invalid
+    bool await_ready() { return Time <= 0.f; }
+
+    // Called when the coroutine has been suspended using this Task
+    void await_suspend(std::coroutine_handle<CoroPromise> CoroHandle)
+    {
+        CoroTimerQueue::Get().Add(Time, CoroHandle);
+    };
+};
+
+// Definition of the coroutine function which fades out the camera. With 60 frames per second every step of the fade
+// is resumed up to 16 milliseconds late, and "stat Coro" shows exactly how much.
+CoroHandle CoroFadeOut()
+{
+    // Warning, there will be velociraptors: World should be obtained by a World Context Object,
+    // but just for the example sake we use nasty GWorld.
+    if (GWorld)
+    {
+        APlayerCameraManager* CameraManager = UGameplayStatics::GetPlayerCameraManager(GWorld, 0);
+        for (int32 Fade = 0; Fade <= 100; Fade += 10)
+        {
+            // Because the WaitSecondsTask can tick between worlds we can't be sure if the Camera Manager
+            // is valid all the time.
+            if (IsValid(CameraManager))
+            {
+                CameraManager->SetManualCameraFade((float)Fade * .01f, FColor::Black, false);
+            }
+            co_await WaitSecondsTask(.1f);
+        }
+    }
+}
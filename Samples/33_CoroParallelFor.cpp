@@ -0,0 +1,719 @@
+// Copyright (c) 2024 Damian Nowakowski. All rights reserved.
+
+// This is the example of c++ coroutine which splits a big loop across all cores of the work-stealing thread pool.
+// The measured times depend on the machine and the amount of it's cores.
+// For more details check: https://github.com/zompi2/cppcorosample
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Chase-Lev work-stealing deque of coroutine Handles. Only the owning worker can push and pop
+// from the bottom, every other worker can steal from the top. The buffer grows when it's full.
+class WorkStealingDeque
+{
+public:
+
+    // Constructor - allocate the initial buffer
+    explicit WorkStealingDeque(int64_t InitialCapacity = 256)
+    {
+        Rings.push_back(std::make_unique<Ring>(InitialCapacity));
+        Array.store(Rings.back().get(), std::memory_order_relaxed);
+    }
+
+    // Push the Handle to the bottom of the deque. Can be called only by the owning worker.
+    void Push(std::coroutine_handle<> Handle)
+    {
+        const int64_t B = Bottom.load(std::memory_order_relaxed);
+        const int64_t T = Top.load(std::memory_order_acquire);
+        Ring* R = Array.load(std::memory_order_relaxed);
+        if (B - T > R->Capacity - 1)
+        {
+            R = Grow(R, B, T);
+        }
+        R->Put(B, Handle.address());
+        Bottom.store(B + 1, std::memory_order_release);
+    }
+
+    // Pop the lastly pushed Handle from the bottom of the deque. Can be called only by the owning worker.
+    std::coroutine_handle<> Pop()
+    {
+        const int64_t B = Bottom.load(std::memory_order_relaxed) - 1;
+        Ring* R = Array.load(std::memory_order_relaxed);
+        Bottom.store(B, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t T = Top.load(std::memory_order_relaxed);
+
+        if (T > B)
+        {
+            // The deque was empty
+            Bottom.store(B + 1, std::memory_order_relaxed);
+            return {};
+        }
+
+        void* Item = R->Get(B);
+        if (T == B)
+        {
+            // This is the last item, so we have to race with thieves for it
+            if (Top.compare_exchange_strong(T, T + 1, std::memory_order_seq_cst, std::memory_order_relaxed) == false)
+            {
+                Item = nullptr;
+            }
+            Bottom.store(B + 1, std::memory_order_relaxed);
+        }
+        return std::coroutine_handle<>::from_address(Item);
+    }
+
+    // Steal the oldest Handle from the top of the deque. Can be called by any thread.
+    std::coroutine_handle<> Steal()
+    {
+        int64_t T = Top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t B = Bottom.load(std::memory_order_acquire);
+
+        if (T < B)
+        {
+            Ring* R = Array.load(std::memory_order_acquire);
+            void* Item = R->Get(T);
+            if (Top.compare_exchange_strong(T, T + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return std::coroutine_handle<>::from_address(Item);
+            }
+        }
+        return {};
+    }
+
+private:
+
+    // Circular buffer of Handle addresses. Capacity is always a power of two.
+    struct Ring
+    {
+        explicit Ring(int64_t InCapacity) :
+            Capacity(InCapacity),
+            Items(std::make_unique<std::atomic<void*>[]>(InCapacity))
+        {}
+
+        void* Get(int64_t Index) const { return Items[Index & (Capacity - 1)].load(std::memory_order_relaxed); }
+        void Put(int64_t Index, void* Item) { Items[Index & (Capacity - 1)].store(Item, std::memory_order_relaxed); }
+
+        const int64_t Capacity;
+        std::unique_ptr<std::atomic<void*>[]> Items;
+    };
+
+    // Create two times bigger buffer and copy all items to it. The old buffer is kept alive,
+    // because thieves might still be reading from it.
+    Ring* Grow(Ring* Old, int64_t B, int64_t T)
+    {
+        Rings.push_back(std::make_unique<Ring>(Old->Capacity * 2));
+        Ring* New = Rings.back().get();
+        for (int64_t i = T; i < B; i++)
+        {
+            New->Put(i, Old->Get(i));
+        }
+        Array.store(New, std::memory_order_release);
+        return New;
+    }
+
+    // Index of the oldest item, moved by thieves
+    alignas(64) std::atomic<int64_t> Top = 0;
+
+    // Index after the newest item, moved by the owner
+    alignas(64) std::atomic<int64_t> Bottom = 0;
+
+    // Currently used buffer
+    std::atomic<Ring*> Array;
+
+    // Every buffer ever allocated by this deque
+    std::vector<std::unique_ptr<Ring>> Rings;
+};
+
+// Thread pool which resumes coroutines on it's worker threads, the same as the CoroThreadPool from the 09_CoroThreadPool.cpp sample.
+// Workers can be pinned to cores, so a worker never moves away from the caches and the NUMA node of the memory it has touched.
+class CoroThreadPool
+{
+public:
+
+    // Awaiter which suspends the coroutine and resumes it on one of the workers
+    class ScheduleAwaiter
+    {
+    public:
+
+        explicit ScheduleAwaiter(CoroThreadPool& InPool) : Pool(InPool) {}
+
+        // Always suspend, so the coroutine can be moved to the pool
+        bool await_ready() const noexcept { return false; }
+
+        // Give the suspended coroutine to the pool
+        void await_suspend(std::coroutine_handle<> Handle) { Pool.Post(Handle); }
+
+        // Called when the coroutine has been resumed on the worker
+        void await_resume() const noexcept {}
+
+    private:
+
+        CoroThreadPool& Pool;
+    };
+
+    // Constructor - start the worker threads, optionally pinned to one core each
+    explicit CoroThreadPool(unsigned NumWorkers = std::thread::hardware_concurrency(), bool bPinWorkers = false)
+    {
+        if (NumWorkers == 0)
+        {
+            NumWorkers = 1;
+        }
+
+        Workers.reserve(NumWorkers);
+        for (unsigned i = 0; i < NumWorkers; i++)
+        {
+            Workers.push_back(std::make_unique<Worker>(i));
+        }
+        const std::vector<int> Cores = bPinWorkers ? GetAllowedCores() : std::vector<int>();
+        for (unsigned i = 0; i < NumWorkers; i++)
+        {
+            Workers[i]->Thread = std::thread([this, i]() { WorkerLoop(i); });
+            // Every pinned worker gets a different core. Workers beyond the amount of allowed cores are left to the system,
+            // because pinning two of them to one core would only stop the system from moving them to an idle one.
+            if (i < Cores.size() && PinToCore(Workers[i]->Thread, Cores[i]))
+            {
+                NumPinned++;
+            }
+        }
+    }
+
+    // Destructor - stop and join the worker threads. Coroutines which are still waiting in the pool are not resumed.
+    ~CoroThreadPool()
+    {
+        bStopping.store(true);
+        WakeEpoch.fetch_add(1);
+        WakeEpoch.notify_all();
+        for (std::unique_ptr<Worker>& W : Workers)
+        {
+            W->Thread.join();
+        }
+    }
+
+    // Use co_await Pool.Schedule() to continue the coroutine on the pool
+    ScheduleAwaiter Schedule() { return ScheduleAwaiter(*this); }
+
+    // Resume the given coroutine Handle on the pool. Can be called from any thread.
+    void Post(std::coroutine_handle<> Handle)
+    {
+        if (CurrentPool == this)
+        {
+            // Worker threads push to their own deque without any locking
+            Workers[CurrentWorkerIndex]->Deque.Push(Handle);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> Lock(InjectMutex);
+            InjectQueue.push_back(Handle);
+            NumInjected.fetch_add(1, std::memory_order_release);
+        }
+        Wake();
+    }
+
+    // Amount of worker threads
+    unsigned NumWorkers() const { return static_cast<unsigned>(Workers.size()); }
+
+    // Check if the current thread is one of the workers of this pool
+    bool IsWorkerThread() const { return CurrentPool == this; }
+
+    // Amount of workers which have been successfully pinned, every one to a different core
+    unsigned GetNumPinned() const { return NumPinned; }
+
+private:
+
+    // Data of a single worker thread
+    struct Worker
+    {
+        explicit Worker(unsigned Index) : RandomState(Index * 2654435761u + 1u) {}
+
+        WorkStealingDeque Deque;
+        std::thread Thread;
+
+        // State of the random number generator used to pick the worker to steal from
+        uint32_t RandomState;
+    };
+
+#if defined(__linux__)
+
+    // Cores this process is allowed to run on, grouped by their NUMA nodes, so workers with close indices share the node.
+    // Core numbers can be interleaved between nodes, so the nodes are read from the sysfs. Allowed cores which are not found
+    // there are added at the end. Hyper-threads of one core are not told apart, so two workers can still share a physical core.
+    static std::vector<int> GetAllowedCores()
+    {
+        cpu_set_t Allowed;
+        CPU_ZERO(&Allowed);
+        if (sched_getaffinity(0, sizeof(Allowed), &Allowed) != 0)
+        {
+            return {};
+        }
+
+        // Find every node, in the order of their numbers
+        std::vector<int> Nodes;
+        std::error_code Error;
+        for (const std::filesystem::directory_entry& Entry : std::filesystem::directory_iterator("/sys/devices/system/node", Error))
+        {
+            int Node = 0;
+            char Rest = 0;
+            if (std::sscanf(Entry.path().filename().c_str(), "node%d%c", &Node, &Rest) == 1)
+            {
+                Nodes.push_back(Node);
+            }
+        }
+        std::sort(Nodes.begin(), Nodes.end());
+
+        // Every cpulist is a list of ranges, like "0-15,32-47"
+        std::vector<int> Cores;
+        for (const int Node : Nodes)
+        {
+            std::ifstream File("/sys/devices/system/node/node" + std::to_string(Node) + "/cpulist");
+            std::string Range;
+            while (std::getline(File, Range, ','))
+            {
+                int First = 0;
+                int Last = 0;
+                const int NumRead = std::sscanf(Range.c_str(), "%d-%d", &First, &Last);
+                if (NumRead < 1)
+                {
+                    continue;
+                }
+                if (NumRead == 1)
+                {
+                    Last = First;
+                }
+                for (int Core = std::max(First, 0); Core <= Last && Core < CPU_SETSIZE; Core++)
+                {
+                    if (CPU_ISSET(Core, &Allowed))
+                    {
+                        Cores.push_back(Core);
+                        CPU_CLR(Core, &Allowed);
+                    }
+                }
+            }
+        }
+        for (int Core = 0; Core < CPU_SETSIZE; Core++)
+        {
+            if (CPU_ISSET(Core, &Allowed))
+            {
+                Cores.push_back(Core);
+            }
+        }
+        return Cores;
+    }
+
+    // Pin the thread to the given core. Returns false if the system doesn't allow it.
+    static bool PinToCore(std::thread& Thread, int Core)
+    {
+        cpu_set_t Set;
+        CPU_ZERO(&Set);
+        CPU_SET(Core, &Set);
+        return pthread_setaffinity_np(Thread.native_handle(), sizeof(Set), &Set) == 0;
+    }
+
+#else
+
+    // Workers are not pinned on other platforms
+    static std::vector<int> GetAllowedCores() { return {}; }
+    static bool PinToCore(std::thread&, int) { return false; }
+
+#endif
+
+    // Find the next coroutine to resume: own deque first, then the inject queue, then other workers
+    std::coroutine_handle<> FindWork(unsigned Index)
+    {
+        Worker& Self = *Workers[Index];
+        if (std::coroutine_handle<> Handle = Self.Deque.Pop())
+        {
+            return Handle;
+        }
+
+        if (NumInjected.load(std::memory_order_acquire) > 0)
+        {
+            std::lock_guard<std::mutex> Lock(InjectMutex);
+            if (InjectQueue.empty() == false)
+            {
+                std::coroutine_handle<> Handle = InjectQueue.front();
+                InjectQueue.pop_front();
+                NumInjected.fetch_sub(1, std::memory_order_relaxed);
+                return Handle;
+            }
+        }
+
+        // Start stealing from a random worker, so thieves don't fight over the same victim
+        Self.RandomState ^= Self.RandomState << 13;
+        Self.RandomState ^= Self.RandomState >> 17;
+        Self.RandomState ^= Self.RandomState << 5;
+        const unsigned Count = NumWorkers();
+        const unsigned Start = Self.RandomState % Count;
+        for (unsigned i = 0; i < Count; i++)
+        {
+            const unsigned Victim = (Start + i) % Count;
+            if (Victim != Index)
+            {
+                if (std::coroutine_handle<> Handle = Workers[Victim]->Deque.Steal())
+                {
+                    return Handle;
+                }
+            }
+        }
+        return {};
+    }
+
+    // Main loop of every worker thread
+    void WorkerLoop(unsigned Index)
+    {
+        CurrentPool = this;
+        CurrentWorkerIndex = Index;
+
+        while (bStopping.load(std::memory_order_relaxed) == false)
+        {
+            if (std::coroutine_handle<> Handle = FindWork(Index))
+            {
+                Handle.resume();
+                continue;
+            }
+
+            // Nothing to do. Announce that we are going to sleep, check the queues once again and sleep until the epoch changes.
+            NumSleeping.fetch_add(1);
+            const uint32_t Epoch = WakeEpoch.load();
+            if (std::coroutine_handle<> Handle = FindWork(Index))
+            {
+                NumSleeping.fetch_sub(1);
+                Handle.resume();
+                continue;
+            }
+            if (bStopping.load() == false)
+            {
+                WakeEpoch.wait(Epoch);
+            }
+            NumSleeping.fetch_sub(1);
+        }
+
+        CurrentPool = nullptr;
+    }
+
+    // Wake up one sleeping worker, if there is any
+    void Wake()
+    {
+        WakeEpoch.fetch_add(1);
+        if (NumSleeping.load() > 0)
+        {
+            WakeEpoch.notify_one();
+        }
+    }
+
+    // All workers of this pool
+    std::vector<std::unique_ptr<Worker>> Workers;
+
+    // Queue for coroutines posted from threads which are not workers of this pool
+    std::mutex InjectMutex;
+    std::deque<std::coroutine_handle<>> InjectQueue;
+    std::atomic<uint32_t> NumInjected = 0;
+
+    // Changed every time a new work is posted, sleeping workers wait for it's change
+    std::atomic<uint32_t> WakeEpoch = 0;
+
+    // Amount of workers pinned to their cores
+    unsigned NumPinned = 0;
+
+    // Amount of workers which are going to sleep or are sleeping
+    std::atomic<uint32_t> NumSleeping = 0;
+
+    // Set when the pool is destroyed
+    std::atomic<bool> bStopping = false;
+
+    // Pool and index of the worker running on the current thread
+    static inline thread_local CoroThreadPool* CurrentPool = nullptr;
+    static inline thread_local unsigned CurrentWorkerIndex = 0;
+};
+
+// State shared by every chunk of a single ParallelFor
+struct CoroForkJoin
+{
+    // Amount of chunks which haven't finished yet, plus one held by the awaiting coroutine while it starts the first chunk
+    std::atomic<std::size_t> Remaining = 0;
+
+    // Coroutine which awaits the ParallelFor
+    std::coroutine_handle<> Continuation;
+
+    // The first exception thrown by any chunk
+    std::atomic<bool> bFailed = false;
+    std::exception_ptr Exception;
+};
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroForkPromise;
+
+// Definition of the coroutine Handle of a single chunk
+struct CoroForkHandle : std::coroutine_handle<CoroForkPromise>
+{
+    // Tell the handle to use our Promise
+    using promise_type = ::CoroForkPromise;
+};
+
+// Definition of the Promise of a single chunk. The chunk destroys itself when it finishes, and the last finished one
+// transfers the execution directly to the awaiting coroutine, on the worker it has finished on.
+struct CoroForkPromise
+{
+    // Awaiter used when the chunk finishes
+    struct FinalAwaiter
+    {
+        bool await_ready() noexcept { return false; }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<CoroForkPromise> Handle) noexcept
+        {
+            // Read everything needed before the count goes down, because the awaiting coroutine can destroy the Join right after it
+            CoroForkJoin& Join = *Handle.promise().Join;
+            const std::coroutine_handle<> Continuation = Join.Continuation;
+            Handle.destroy();
+            if (Join.Remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                return Continuation;
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    // ParallelFor this chunk belongs to
+    CoroForkJoin* Join = nullptr;
+
+    // Called in order to construct the coroutine Handle
+    CoroForkHandle get_return_object() { return { CoroForkHandle::from_promise(*this) }; }
+
+    // Suspend the chunk at the beginning, so it can be given to the pool
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    // Count the chunk down at the end
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    // Called when co_return is used
+    void return_void() {}
+
+    // Called when exception occurs. Remember only the first one, it is rethrown to the awaiting coroutine.
+    void unhandled_exception()
+    {
+        if (Join->bFailed.exchange(true, std::memory_order_relaxed) == false)
+        {
+            Join->Exception = std::current_exception();
+        }
+    }
+};
+
+// Awaiter which calls the Body for every chunk of the range on the pool and resumes the awaiting coroutine when the last chunk finishes.
+// The range is split in halves recursively: the chunk gives it's upper half to the pool and continues with the lower one,
+// until it is not bigger than the Grain. The worker pushes halves to it's own deque, so idle workers steal the biggest halves first
+// and split them further on their own cores, without any central queue.
+template<typename F>
+class ParallelForAwaiter : private CoroForkJoin
+{
+public:
+
+    ParallelForAwaiter(CoroThreadPool& InPool, std::size_t InBegin, std::size_t InEnd, std::size_t InGrain, F InBody) :
+        Pool(InPool),
+        Begin(InBegin),
+        End(InEnd),
+        Grain(std::max<std::size_t>(InGrain, 1)),
+        Body(std::move(InBody))
+    {}
+
+    // Don't suspend for the empty range
+    bool await_ready() const noexcept { return Begin >= End; }
+
+    // Start the first chunk. If all chunks have finished before it returns, the coroutine doesn't suspend at all.
+    bool await_suspend(std::coroutine_handle<> Handle)
+    {
+        Continuation = Handle;
+        Remaining.store(1, std::memory_order_relaxed);
+        Spawn(Begin, End);
+        return Remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+
+    // Rethrow the exception thrown by any chunk
+    void await_resume()
+    {
+        if (Exception)
+        {
+            std::rethrow_exception(Exception);
+        }
+    }
+
+private:
+
+    // Give the chunk to the pool
+    void Spawn(std::size_t From, std::size_t To)
+    {
+        CoroForkHandle Handle = Split(From, To);
+        Handle.promise().Join = this;
+
+        // The spawning chunk still holds it's own count, so the counter can't reach zero before this one is added
+        Remaining.fetch_add(1, std::memory_order_relaxed);
+        Pool.Post(Handle);
+    }
+
+    // Coroutine of a single chunk
+    CoroForkHandle Split(std::size_t From, std::size_t To)
+    {
+        while (To - From > Grain)
+        {
+            const std::size_t Mid = From + (To - From) / 2;
+            Spawn(Mid, To);
+            To = Mid;
+        }
+        Body(From, To);
+        co_return;
+    }
+
+    CoroThreadPool& Pool;
+    const std::size_t Begin;
+    const std::size_t End;
+    const std::size_t Grain;
+
+    // Called for every chunk, at the same time from many workers
+    F Body;
+};
+
+// Use co_await ParallelFor(Pool, Begin, End, Grain, Body) to call Body(From, To) for chunks of the [Begin, End) range on the pool.
+// The awaiting coroutine continues on the worker which has finished the last chunk.
+template<typename F>
+ParallelForAwaiter<F> ParallelFor(CoroThreadPool& Pool, std::size_t Begin, std::size_t End, std::size_t Grain, F Body)
+{
+    return ParallelForAwaiter<F>(Pool, Begin, End, Grain, std::move(Body));
+}
+
+// Forward declaration of the Promise so it can be used for a Handle definition
+struct CoroPromise;
+
+// Definition of the fire and forget coroutine Handle using our Promise
+struct CoroHandle : std::coroutine_handle<CoroPromise>
+{
+    using promise_type = ::CoroPromise;
+};
+
+// Definition of the fire and forget coroutine Promise
+struct CoroPromise
+{
+    CoroHandle get_return_object() { return { CoroHandle::from_promise(*this) }; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() {}
+};
+
+// Result of a single job
+struct FJobResult
+{
+    uint64_t Sum = 0;
+    uint64_t NumChunks = 0;
+    bool bResumedOnWorker = false;
+};
+
+// A bit of CPU heavy work for a single value
+uint64_t Mix(uint64_t Value)
+{
+    for (int i = 0; i < 32; i++)
+    {
+        Value ^= Value >> 33;
+        Value *= 0xff51afd7ed558ccdull;
+    }
+    return Value & 0xffff;
+}
+
+// Job which starts on the main thread and sums mixed values of the whole array on the pool
+CoroHandle CoroSumJob(CoroThreadPool& Pool, const std::vector<uint64_t>& Values, FJobResult& Result, std::latch& Done)
+{
+    std::atomic<uint64_t> Sum = 0;
+    std::atomic<uint64_t> NumChunks = 0;
+
+    co_await ParallelFor(Pool, 0, Values.size(), 4096, [&](std::size_t From, std::size_t To)
+    {
+        uint64_t ChunkSum = 0;
+        for (std::size_t i = From; i < To; i++)
+        {
+            ChunkSum += Mix(Values[i]);
+        }
+        Sum.fetch_add(ChunkSum, std::memory_order_relaxed);
+        NumChunks.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    Result.Sum = Sum.load();
+    Result.NumChunks = NumChunks.load();
+    Result.bResumedOnWorker = Pool.IsWorkerThread();
+    Done.count_down();
+}
+
+// Run the job on the pool with the given amount of workers and print how long it took
+void RunSumJob(const std::vector<uint64_t>& Values, unsigned NumWorkers, bool bPinWorkers)
+{
+    FJobResult Result;
+    std::latch Done(1);
+
+    // The pool is declared as the last one, so it's workers are joined before the result and the latch are destroyed
+    CoroThreadPool Pool(NumWorkers, bPinWorkers);
+
+    const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+    CoroSumJob(Pool, Values, Result, Done);
+    Done.wait();
+    const std::chrono::steady_clock::duration Time = std::chrono::steady_clock::now() - Start;
+
+    std::cout << "Workers " << NumWorkers;
+    if (bPinWorkers)
+    {
+        std::cout << " (" << Pool.GetNumPinned() << " pinned)";
+    }
+    std::cout << ": sum " << Result.Sum << ", " << Result.NumChunks << " chunks"
+        << ", resumed on a worker: " << (Result.bResumedOnWorker ? "yes" : "no")
+        << ", " << std::chrono::duration_cast<std::chrono::milliseconds>(Time).count() << " ms\n";
+}
+
+// Main program
+int main()
+{
+    std::vector<uint64_t> Values(1 << 22);
+    for (std::size_t i = 0; i < Values.size(); i++)
+    {
+        Values[i] = i * 2654435761ull;
+    }
+
+    for (const unsigned NumWorkers : { 1u, 2u, 4u, 8u })
+    {
+        RunSumJob(Values, NumWorkers, false);
+    }
+    RunSumJob(Values, 8, true);
+
+    return 0;
+}
+
+/**
+ The program should output something like (the times were measured on the machine with a single core,
+ on the machine with more cores they should go down with the amount of workers, up to the amount of cores):
+
+ Workers 1: sum 137493855747, 1024 chunks, resumed on a worker: yes, 103 ms
+ Workers 2: sum 137493855747, 1024 chunks, resumed on a worker: yes, 106 ms
+ Workers 4: sum 137493855747, 1024 chunks, resumed on a worker: yes, 113 ms
+ Workers 8: sum 137493855747, 1024 chunks, resumed on a worker: yes, 107 ms
+ Workers 8 (1 pinned): sum 137493855747, 1024 chunks, resumed on a worker: yes, 102 ms
+*/